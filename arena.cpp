@@ -0,0 +1,108 @@
+#include "arena.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long long> heapAllocations{ 0 };
+
+// every C++ heap allocation in the program goes through here, and so do the arena's
+// own blocks, so allocation-free frames can be checked rather than assumed
+void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+long long heapAllocationCount() {
+    return heapAllocations.load(std::memory_order_relaxed);
+}
+
+// throws like operator new, so a failed block never becomes a NULL base or overflow pointer
+static unsigned char* heapBlock(size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return (unsigned char*)p;
+    throw std::bad_alloc();
+}
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void* arenaAlloc(Arena& arena, size_t size, size_t alignment) {
+    if (arena.base == NULL) {
+        arena.capacity = arena.initialCapacity;
+        arena.base = heapBlock(arena.capacity);
+        arena.heapBlocks++;
+    }
+    arena.allocations++;
+
+    // base comes from malloc, so offsets aligned within it are aligned in memory
+    size_t start = alignUp(arena.used, alignment);
+    if (start + size <= arena.capacity) {
+        arena.used = start + size;
+        if (arena.used + arena.overflowBytes > arena.peak) arena.peak = arena.used + arena.overflowBytes;
+        return arena.base + start;
+    }
+
+    unsigned char* block = heapBlock(size + alignment);
+    arena.overflow.push_back(block);
+    arena.overflowBytes += size + alignment;
+    arena.heapBlocks++;
+    if (arena.used + arena.overflowBytes > arena.peak) arena.peak = arena.used + arena.overflowBytes;
+    return (void*)alignUp((size_t)block, alignment);
+}
+
+void resetArena(Arena& arena) {
+    if (!arena.overflow.empty()) {
+        size_t needed = arena.used + arena.overflowBytes;
+        for (unsigned char* block : arena.overflow) free(block);
+        arena.overflow.clear();
+        arena.overflowBytes = 0;
+
+        while (arena.capacity < needed) arena.capacity *= 2;
+        free(arena.base);
+        arena.base = NULL; // a throwing heapBlock must not leave the freed block behind
+        arena.base = heapBlock(arena.capacity);
+        arena.heapBlocks++;
+    }
+    arena.used = 0;
+}
+
+void freeArena(Arena& arena) {
+    resetArena(arena);
+    free(arena.base);
+    arena.base = NULL;
+    arena.capacity = 0;
+}
+
+Arena& frameArena() {
+    static Arena arena;
+    if (arena.initialCapacity == 0) arena.initialCapacity = FRAME_ARENA_SIZE;
+    return arena;
+}
+
+Arena& sceneArena() {
+    static Arena arena;
+    if (arena.initialCapacity == 0) arena.initialCapacity = SCENE_ARENA_SIZE;
+    return arena;
+}
@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <vector>
+#include <cstddef>
+
+// linear allocator for transient geometry: one block and a bump offset, freed all at once
+// frameArena() is reset at the end of every frame, sceneArena() when a scene is torn down;
+// anything that can run mid-frame (uploads, re-layouts, stats) uses the frame arena,
+// the scene arena only holds scene setup data; both are for the main thread only
+// an allocation that does not fit takes a heap block, and the next reset grows the main
+// block to cover it, so a steady-state frame allocates nothing from the heap
+#define FRAME_ARENA_SIZE (1u << 20)
+#define SCENE_ARENA_SIZE (1u << 20)
+
+struct Arena {
+    unsigned char* base = NULL;
+    size_t capacity = 0, used = 0;
+    size_t initialCapacity = 0;
+    std::vector<unsigned char*> overflow; // heap blocks since the last reset
+    size_t overflowBytes = 0;
+
+    size_t peak = 0;          // most bytes in use between two resets
+    long long allocations = 0;
+    long long heapBlocks = 0; // overflow blocks and base growths over the arena's life
+};
+
+void* arenaAlloc(Arena& arena, size_t size, size_t alignment);
+
+template <typename T>
+T* arenaArray(Arena& arena, size_t count) {
+    return (T*)arenaAlloc(arena, count * sizeof(T), alignof(T));
+}
+
+// O(1) unless the cycle overflowed, then the main block is reallocated once to fit it
+void resetArena(Arena& arena);
+void freeArena(Arena& arena);
+
+Arena& frameArena();
+Arena& sceneArena();
+
+// calls to the global operator new plus arena heap blocks since startup
+long long heapAllocationCount();
+
+#endif
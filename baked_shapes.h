@@ -0,0 +1,129 @@
+#ifndef BAKED_SHAPES_H
+#define BAKED_SHAPES_H
+#include "shapes.h"
+
+// compile-time tessellation for shapes whose parameters are all constants
+// the generators mirror writeRing/writeStar/writeFlower but run in constexpr, so a
+// static constexpr BakedMesh is finished data in the binary's read-only section:
+// no trigonometry at startup, and the pages are shared by every process running it
+// counts are template parameters and size the arrays; pass the shape's own count,
+// e.g. bakeRing<hexagon.segments>(hexagon)
+// plain arrays rather than std::array: its operator[] is not constexpr for writes in C++14
+#define BAKED_PI 3.14159265358979323846
+
+template <int VertexCount, int IndexCount>
+struct BakedMesh {
+    float vertices[VertexCount * 5]; // [x, y, r, g, b]
+    unsigned int indices[IndexCount]; // triangle list from vertex 0
+
+    static constexpr int vertexCount = VertexCount;
+    static constexpr int indexCount = IndexCount;
+};
+
+// reduced to [-pi, pi]; the Taylor series is below 1e-12 off there, far under float precision
+constexpr double bakedSin(double x) {
+    while (x > BAKED_PI) x -= 2.0 * BAKED_PI;
+    while (x < -BAKED_PI) x += 2.0 * BAKED_PI;
+
+    double term = x, sum = x;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double bakedCos(double x) {
+    return bakedSin(x + BAKED_PI / 2.0);
+}
+
+template <int V, int I>
+constexpr void bakeVertex(BakedMesh<V, I>& mesh, int vertex, double x, double y, Color c) {
+    float* out = mesh.vertices + vertex * 5;
+    out[0] = (float)x;
+    out[1] = (float)y;
+    out[2] = c.r;
+    out[3] = c.g;
+    out[4] = c.b;
+}
+
+constexpr Color bakedMix(Color a, Color b, double t) {
+    return { (float)(a.r + (b.r - a.r) * t), (float)(a.g + (b.g - a.g) * t), (float)(a.b + (b.b - a.b) * t) };
+}
+
+// {0, i, i + 1} fan over RimCount rim vertices, same order as writeFanIndices
+template <int RimCount, int V, int I>
+constexpr void bakeFanIndices(BakedMesh<V, I>& mesh) {
+    for (int i = 1; i <= RimCount; i++) {
+        mesh.indices[(i - 1) * 3] = 0;
+        mesh.indices[(i - 1) * 3 + 1] = i;
+        mesh.indices[(i - 1) * 3 + 2] = i % RimCount + 1;
+    }
+}
+
+template <int Segments>
+constexpr BakedMesh<Segments + 1, Segments * 3> bakeRing(const RingShape& shape) {
+    BakedMesh<Segments + 1, Segments * 3> mesh = {};
+    bakeVertex(mesh, 0, shape.centerX, shape.centerY, shape.center);
+
+    double step = 2.0 * BAKED_PI / Segments;
+    for (int k = 0; k < Segments; k++) {
+        double angle = shape.startAngle + k * step;
+        double s = bakedSin(angle), c = bakedCos(angle);
+        double t = (shape.gradient == GRADIENT_SINE) ? 0.5 + 0.5 * s : (double)k / Segments;
+        bakeVertex(mesh, k + 1, shape.centerX + shape.radiusX * c, shape.centerY + shape.radiusY * s,
+                   bakedMix(shape.rimFrom, shape.rimTo, t));
+    }
+
+    bakeFanIndices<Segments>(mesh);
+    return mesh;
+}
+
+template <int Points>
+constexpr BakedMesh<Points * 2 + 1, Points * 2 * 3> bakeStar(const StarShape& shape) {
+    BakedMesh<Points * 2 + 1, Points * 2 * 3> mesh = {};
+    bakeVertex(mesh, 0, shape.centerX, shape.centerY, shape.center);
+
+    double step = BAKED_PI / Points;
+    for (int k = 0; k < Points * 2; k++) {
+        double angle = shape.startAngle + k * step;
+        bool outer = (k % 2 == 0);
+        double radius = outer ? shape.outerRadius : shape.innerRadius;
+        bakeVertex(mesh, k + 1, shape.centerX + radius * bakedCos(angle), shape.centerY + radius * bakedSin(angle),
+                   outer ? shape.outer : shape.inner);
+    }
+
+    bakeFanIndices<Points * 2>(mesh);
+    return mesh;
+}
+
+template <int Petals>
+constexpr BakedMesh<Petals * 3, Petals * 3> bakeFlower(const FlowerShape& shape) {
+    BakedMesh<Petals * 3, Petals * 3> mesh = {};
+    for (int petal = 0; petal < Petals; petal++) {
+        double petalAngle = petal * 2.0 * BAKED_PI / Petals;
+
+        Color color = {
+            (float)(0.5 + 0.5 * bakedSin(petalAngle)),
+            (float)(0.5 + 0.5 * bakedSin(petalAngle + 2.0 * BAKED_PI / 3)),
+            (float)(0.5 + 0.5 * bakedSin(petalAngle + 4.0 * BAKED_PI / 3))
+        };
+        Color centerColor = { color.r * shape.centerShade, color.g * shape.centerShade, color.b * shape.centerShade };
+
+        double sideAngle = petalAngle + BAKED_PI / Petals;
+
+        int first = petal * 3;
+        bakeVertex(mesh, first, shape.centerX, shape.centerY, centerColor);
+        bakeVertex(mesh, first + 1, shape.centerX + shape.petalLength * bakedCos(petalAngle),
+                   shape.centerY + shape.petalLength * bakedSin(petalAngle), color);
+        bakeVertex(mesh, first + 2, shape.centerX + shape.petalWidth * bakedCos(sideAngle),
+                   shape.centerY + shape.petalWidth * bakedSin(sideAngle), color);
+
+        mesh.indices[first] = first;
+        mesh.indices[first + 1] = first + 1;
+        mesh.indices[first + 2] = first + 2;
+    }
+    return mesh;
+}
+
+#endif
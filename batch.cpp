@@ -0,0 +1,99 @@
+#include "batch.h"
+#include "gl_state.h"
+#include "frame_stats.h"
+
+void addShape(ShapeBatch& batch, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    unsigned int base = (unsigned int)(batch.vertices.size() / 5);
+
+    batch.vertices.insert(batch.vertices.end(), vertices, vertices + vertexCount * 5);
+
+    batch.indices.reserve(batch.indices.size() + indexCount);
+    for (size_t i = 0; i < indexCount; i++) {
+        batch.indices.push_back(base + indices[i]);
+    }
+    batch.shapeEnds.push_back(batch.indices.size());
+}
+
+void addShape(ShapeBatch& batch, const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+    addShape(batch, vertices.data(), vertices.size() / 5, indices.data(), indices.size());
+}
+
+BatchSlot reserveShape(ShapeBatch& batch, MeshSize size) {
+    size_t vertexOffset = batch.vertices.size();
+    size_t indexOffset = batch.indices.size();
+
+    batch.vertices.resize(vertexOffset + size.vertices * 5);
+    batch.indices.resize(indexOffset + size.indices);
+    batch.shapeEnds.push_back(batch.indices.size());
+
+    return { batch.vertices.data() + vertexOffset, batch.indices.data() + indexOffset, (unsigned int)(vertexOffset / 5) };
+}
+
+void addShape(ShapeBatch& batch, const RingShape& shape) {
+    BatchSlot slot = reserveShape(batch, ringSize(shape));
+    writeRing(shape, slot.vertices, slot.indices, slot.baseVertex);
+}
+
+void addShape(ShapeBatch& batch, const StarShape& shape) {
+    BatchSlot slot = reserveShape(batch, starSize(shape));
+    writeStar(shape, slot.vertices, slot.indices, slot.baseVertex);
+}
+
+void addShape(ShapeBatch& batch, const FlowerShape& shape) {
+    BatchSlot slot = reserveShape(batch, flowerSize(shape));
+    writeFlower(shape, slot.vertices, slot.indices, slot.baseVertex);
+}
+
+void uploadBatch(ShapeBatch& batch) {
+    if (batch.VAO == 0) {
+        glGenVertexArrays(1, &batch.VAO);
+        glGenBuffers(1, &batch.VBO);
+        glGenBuffers(1, &batch.EBO);
+    }
+
+    cachedBindVertexArray(batch.VAO);
+    // welding and renumbering span the batch, triangle reordering stays inside each shape
+    optimizeMesh(batch.vertices, batch.indices, &batch.optimizeReport, batch.shapeEnds.data(), batch.shapeEnds.size());
+
+    // staging copies only live until the upload, so they come from the frame arena
+    Arena& arena = frameArena();
+    size_t vertexCount = batch.vertices.size() / 5;
+    size_t vertexBytes = vertexCount * batch.vertexFormat->stride;
+    unsigned char* encoded = arenaArray<unsigned char>(arena, vertexBytes);
+    encodeVertices(*batch.vertexFormat, batch.vertices.data(), vertexCount, encoded);
+    cachedBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, encoded, GL_STATIC_DRAW);
+    PackedIndices packed;
+    packIndices(batch.indices.data(), batch.indices.size(), arena, packed);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, packed.bytes, packed.data, GL_STATIC_DRAW);
+    applyVertexFormat(*batch.vertexFormat);
+    cachedBindVertexArray(0);
+
+    batch.indexFormat = packed.format;
+    batch.indexCount = packed.count;
+    batch.indexBytes = packed.bytes;
+    batch.vertexBytes = vertexBytes;
+}
+
+void drawBatch(const ShapeBatch& batch) {
+    beginTimedDraw();
+    cachedBindVertexArray(batch.VAO);
+    drawIndexed(batch.indexFormat, batch.indexCount, 1);
+    endTimedDraw((long long)(batch.vertices.size() / 5));
+}
+
+void deleteBatch(ShapeBatch& batch) {
+    forgetVertexArray(batch.VAO);
+    forgetBuffers(1, &batch.VBO);
+    forgetBuffers(1, &batch.EBO);
+    glDeleteVertexArrays(1, &batch.VAO);
+    glDeleteBuffers(1, &batch.VBO);
+    glDeleteBuffers(1, &batch.EBO);
+    batch.VAO = batch.VBO = batch.EBO = 0;
+    batch.indexCount = 0;
+    batch.indexBytes = batch.vertexBytes = 0;
+    batch.vertices.clear();
+    batch.indices.clear();
+    batch.shapeEnds.clear();
+}
@@ -0,0 +1,50 @@
+#ifndef BATCH_H
+#define BATCH_H
+#include "gl_loader.h"
+#include <vector>
+#include <cstddef>
+#include "shapes.h"
+#include "index_buffer.h"
+#include "vertex_format.h"
+#include "mesh_optimizer.h"
+
+// all shapes of a scene merged into one VBO/EBO and drawn with a single call
+// vertices are interleaved [x, y, r, g, b], indices are rebased on add
+// the CPU side is a triangle list; uploadBatch optimizes it in place
+// (see mesh_optimizer.h), packs the indices and converts the vertices to vertexFormat
+struct ShapeBatch {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<size_t> shapeEnds; // end of each shape's indices; the optimizer reorders within them only
+    const VertexFormat* vertexFormat = &floatVertexFormat;
+
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    IndexFormat indexFormat;
+    GLsizei indexCount = 0;   // packed indices in the EBO, restart markers included
+    size_t indexBytes = 0;
+    size_t vertexBytes = 0;
+    MeshOptimizeReport optimizeReport;
+};
+
+void addShape(ShapeBatch& batch, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+void addShape(ShapeBatch& batch, const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
+
+// grows the batch by an exact mesh size; the pointers are valid until the next add
+struct BatchSlot {
+    float* vertices;
+    unsigned int* indices;
+    unsigned int baseVertex;
+};
+
+BatchSlot reserveShape(ShapeBatch& batch, MeshSize size);
+
+// tessellates straight into the batch storage
+void addShape(ShapeBatch& batch, const RingShape& shape);
+void addShape(ShapeBatch& batch, const StarShape& shape);
+void addShape(ShapeBatch& batch, const FlowerShape& shape);
+
+void uploadBatch(ShapeBatch& batch);
+void drawBatch(const ShapeBatch& batch);
+void deleteBatch(ShapeBatch& batch);
+
+#endif
@@ -0,0 +1,588 @@
+#include "offscreen.h"
+#include "gl_state.h"
+#include "shaders.h"
+#include "program_cache.h"
+#include "batch.h"
+#include "shape_list.h"
+#include "stream_buffer.h"
+#include "job_system.h"
+#include "instancing.h"
+#include "sdf.h"
+#include "lod.h"
+#include "softraster.h"
+#include "frame_stats.h"
+#include "sincos.h"
+#include "arena.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#define PI 3.14159265358979323846f
+
+// --backend soft fails a scene with any pixel further than this from the GL reference
+#define SOFT_TOLERANCE 2
+
+// stress test of the task scenes: N copies in a grid, M segments per round shape,
+// K nested squares, rendered headless for a fixed frame count
+struct BenchConfig {
+    std::string scene = "all";
+    int copies = 100;
+    int segments = 30;
+    int squares = 6;
+    int frames = 300;
+    int rebuilds = 20;
+    int width = 1024, height = 1024;
+    const VertexFormat* vertexFormat = &floatVertexFormat;
+    float lodError = 0.0f; // > 0: segments from projected size at this chord error in pixels, else fixed
+    bool sdf = false; // round shapes as SDF quads instead of tessellated fans
+    bool soft = false; // CPU rasterizer instead of GL, one GL frame kept as reference
+    int threads = 0;
+    float dirtyPercent = -1.0f; // >= 0: mesh shapes live in a ShapeList and this share of them moves every frame
+    bool stream = false; // re-tessellate every frame into a StreamBatch
+    bool streamPersistent = true; // false: glMapBufferRange path even with buffer storage
+    int jobThreads = 0; // > 0: tessellation timed from shape descriptors on this many threads
+    JobSystem* jobs = NULL;
+    bool csv = false;
+    bool help = false;
+};
+
+struct BenchScene {
+    ShapeBatch batch;
+    ShapeList shapes; // replaces batch with --dirty
+    StreamBatch stream; // streams batch every frame with --stream
+    InstancedMesh squareMesh;
+    std::vector<Instance> squares;
+    SdfBatch sdfBatch;
+    std::vector<SdfShape> sdfShapes;
+};
+
+// maps the task's [-1, 1] layout into one grid cell
+struct Cell {
+    float x, y, scale;
+    float px(float v) const { return x + v * scale; }
+    float py(float v) const { return y + v * scale; }
+};
+
+static Cell gridCell(int copy, int copies) {
+    int grid = (int)std::ceil(std::sqrt((float)copies));
+    float scale = 1.0f / grid;
+    return { -1.0f + scale * (2 * (copy % grid) + 1), -1.0f + scale * (2 * (copy / grid) + 1), scale };
+}
+
+// tessellated shapes go to the batch, or to the retained list with --dirty
+template <typename Shape>
+static void addMesh(BenchScene& scene, const BenchConfig& config, const Shape& shape) {
+    if (config.dirtyPercent >= 0.0f) addShape(scene.shapes, shape);
+    else addShape(scene.batch, shape);
+}
+
+static void addMesh(BenchScene& scene, const BenchConfig& config, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    if (config.dirtyPercent >= 0.0f) addShape(scene.shapes, vertices, vertexCount, indices, indexCount);
+    else addShape(scene.batch, vertices, vertexCount, indices, indexCount);
+}
+
+static void addTriangle(BenchScene& scene, const BenchConfig& config, const Cell& c, const float* corners, Color a, Color b, Color d) {
+    float vertices[] = {
+        c.px(corners[0]), c.py(corners[1]), a.r, a.g, a.b,
+        c.px(corners[2]), c.py(corners[3]), b.r, b.g, b.b,
+        c.px(corners[4]), c.py(corners[5]), d.r, d.g, d.b
+    };
+    unsigned int indices[] = { 0, 1, 2 };
+    addMesh(scene, config, vertices, 3, indices, 3);
+}
+
+static void buildTriangle(BenchScene& scene, const BenchConfig& config, const Cell& c) {
+    float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.0f, 0.5f };
+    Color red = { 1.0f, 0.0f, 0.0f };
+    addTriangle(scene, config, c, corners, red, red, red);
+}
+
+static void buildSquare(BenchScene& scene, const BenchConfig& config, const Cell& c) {
+    float vertices[20];
+    float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f };
+    for (int i = 0; i < 4; i++) {
+        float v[] = { c.px(corners[i * 2]), c.py(corners[i * 2 + 1]), 0.0f, 0.0f, 1.0f };
+        memcpy(vertices + i * 5, v, sizeof(v));
+    }
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    addMesh(scene, config, vertices, 4, indices, 6);
+}
+
+static void addRound(BenchScene& scene, const BenchConfig& config, const RingShape& ring) {
+    if (config.sdf) scene.sdfShapes.push_back(sdfEllipse(ring));
+    else addMesh(scene, config, ring);
+}
+
+static void addPolygon(BenchScene& scene, const BenchConfig& config, const RingShape& ring) {
+    if (config.sdf) scene.sdfShapes.push_back(sdfPolygon(ring));
+    else addMesh(scene, config, ring);
+}
+
+static int ringSegments(const BenchConfig& config, float radiusX, float radiusY) {
+    if (config.lodError <= 0.0f) return config.segments;
+
+    LodSettings lod;
+    lod.maxChordError = config.lodError;
+    return segmentsForRadius(projectedRadius(radiusX, radiusY, config.width, config.height), lod);
+}
+
+static void buildPart1(BenchScene& scene, const BenchConfig& config, const Cell& c) {
+    float ellipseX = 0.2f * c.scale, ellipseY = 0.12f * c.scale, circle = 0.18f * c.scale;
+    addRound(scene, config, makeEllipse(c.px(-0.5f), c.py(0.5f), ellipseX, ellipseY, ringSegments(config, ellipseX, ellipseY), { 1.0f, 0.0f, 0.0f }));
+
+    float corners[] = { 0.0f, 0.7f, -0.15f, 0.3f, 0.15f, 0.3f };
+    addTriangle(scene, config, c, corners, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f });
+
+    addRound(scene, config, makeCircle(c.px(0.5f), c.py(0.5f), circle, ringSegments(config, circle, circle),
+                                       { 0.5f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }));
+
+    // same 0.4 -> 0.1 size range as the task, split into K layers
+    for (int layer = 0; layer < config.squares; layer++) {
+        float size = 0.4f - layer * (0.3f / std::max(1, config.squares - 1));
+        float color = (layer % 2 == 0) ? 1.0f : 0.0f;
+        scene.squares.push_back({ c.px(0.0f), c.py(-0.25f), size * c.scale, size * c.scale, 0.0f, { color, color, color } });
+    }
+}
+
+static void buildPart2(BenchScene& scene, const BenchConfig& config, const Cell& c) {
+    StarShape star = { c.px(0.0f), c.py(0.6f), 0.25f * c.scale, 0.1f * c.scale, -PI / 2, 5,
+                       { 1.0f, 1.0f, 0.2f }, { 1.0f, 0.6f, 0.0f }, { 1.0f, 1.0f, 0.0f } };
+    if (config.sdf) scene.sdfShapes.push_back(sdfStar(star));
+    else addMesh(scene, config, star);
+    addPolygon(scene, config, makeRegularPolygon(c.px(-0.5f), c.py(0.0f), 0.2f * c.scale, 6,
+                                             { 0.5f, 0.0f, 0.8f }, { 0.5f, 0.1f, 0.8f }, { 0.9f, 0.4f, 0.6f }));
+    addPolygon(scene, config, makeRegularPolygon(c.px(0.5f), c.py(0.0f), 0.18f * c.scale, 8,
+                                             { 0.0f, 0.8f, 1.0f }, { 0.0f, 0.8f, 1.0f }, { 0.0f, 0.3f, 1.0f }));
+    FlowerShape flower = { c.px(0.0f), c.py(-0.4f), 0.15f * c.scale, 0.05f * c.scale, 8, 0.7f };
+    addMesh(scene, config, flower);
+}
+
+typedef void (*BuildFunction)(BenchScene&, const BenchConfig&, const Cell&);
+
+struct BenchEntry {
+    const char* name;
+    BuildFunction build;
+};
+
+static const BenchEntry entries[] = {
+    { "triangle", buildTriangle },
+    { "square", buildSquare },
+    { "part1", buildPart1 },
+    { "part2", buildPart2 }
+};
+
+static void buildScene(BenchScene& scene, const BenchEntry& entry, const BenchConfig& config) {
+    scene.batch.vertices.clear();
+    scene.batch.indices.clear();
+    scene.batch.shapeEnds.clear();
+    scene.shapes = ShapeList();
+    scene.squares.clear();
+    scene.sdfShapes.clear();
+    for (int copy = 0; copy < config.copies; copy++) {
+        entry.build(scene, config, gridCell(copy, config.copies));
+    }
+}
+
+struct BenchResult {
+    size_t vertices = 0, indices = 0, vertexBytes = 0, indexBytes = 0;
+    size_t uploadedVertices = 0, sdfShapes = 0;
+    double acmrBefore = 0.0, acmrAfter = 0.0;
+    int softMaxDiff = 0;
+    size_t softDiffPixels = 0; // pixels with a channel more than SOFT_TOLERANCE levels away from GL
+    int drawCalls = 0;
+    long long stateCalls = 0, stateSkipped = 0; // cached state changes over the timed frames
+    double uploadBytesPerFrame = 0.0, uploadRangesPerFrame = 0.0; // --dirty only
+    const char* streamMode = "off";
+    long long streamWaits = 0; // frames that found their ring region still in use
+    double streamWaitMs = 0.0;
+    double seconds = 0.0;
+    double tessVerticesPerSecond = 0.0;
+    double heapAllocsPerFrame = 0.0; // timed frames after the first, frame arena reset after each
+    size_t frameArenaPeak = 0;
+    FramePercentiles cpu = {}, gpu = {};
+};
+
+static void drawGL(BenchScene& scene, const OffscreenTarget& target, GLuint shaderProgram, GLuint instancedProgram, GLuint sdfProgram) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    cachedUseProgram(shaderProgram);
+    if (scene.stream.VAO != 0) drawStreamBatch(scene.stream);
+    else if (scene.shapes.VAO != 0) drawShapeList(scene.shapes);
+    else drawBatch(scene.batch);
+    if (!scene.sdfShapes.empty()) {
+        cachedUseProgram(sdfProgram);
+        drawSdfBatch(scene.sdfBatch);
+    }
+    if (!scene.squares.empty()) {
+        cachedUseProgram(instancedProgram);
+        drawInstanced(scene.squareMesh);
+    }
+}
+
+static void drawSoft(SoftRasterizer& raster, const BenchScene& scene) {
+    softClear(raster, { 0.0f, 0.0f, 0.0f });
+    softDrawTriangles(raster, scene.batch.vertices.data(), scene.batch.vertices.size() / 5, scene.batch.indices.data(), scene.batch.indices.size());
+    softDrawInstanced(raster, unitSquareMesh.vertices, unitSquareMesh.vertexCount, unitSquareMesh.indices, unitSquareMesh.indexCount,
+                      scene.squares.data(), scene.squares.size());
+    softFlush(raster);
+}
+
+// dashboard-style update: a random share of the retained shapes moves a little, back and forth
+static void moveDirtyShapes(ShapeList& shapes, float percent, int frame, unsigned int& seed) {
+    int count = (int)(shapes.shapes.size() * percent / 100.0f + 0.5f);
+    float offset = (frame % 2 == 0) ? 0.001f : -0.001f;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        moveShape(shapes, (int)((seed >> 8) % shapes.shapes.size()), offset, 0.0f);
+    }
+}
+
+static bool runBenchmark(const BenchEntry& entry, const BenchConfig& config, GLuint shaderProgram, GLuint instancedProgram, BenchResult& result) {
+    BenchScene scene;
+
+    bool retained = config.dirtyPercent >= 0.0f;
+
+    // tessellation throughput: rebuild the CPU geometry several times, into a batch,
+    // or with --jobs from shape descriptors into pre-sized slices on the job system
+    BenchConfig batchConfig = config, listConfig = config;
+    batchConfig.dirtyPercent = -1.0f;
+    listConfig.dirtyPercent = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    if (config.jobThreads > 0) {
+        buildScene(scene, entry, listConfig);
+        scene.shapes.jobs = config.jobs;
+        size_t indexCount = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < config.rebuilds; i++) {
+            tessellateShapeList(scene.shapes, frameArena(), indexCount);
+            resetArena(frameArena());
+        }
+        result.vertices = scene.shapes.vertices.size() / 5;
+        result.indices = indexCount;
+    } else {
+        for (int i = 0; i < config.rebuilds; i++) {
+            buildScene(scene, entry, batchConfig);
+        }
+        result.vertices = scene.batch.vertices.size() / 5;
+        result.indices = scene.batch.indices.size();
+    }
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.tessVerticesPerSecond = buildSeconds > 0.0 ? result.vertices * (double)config.rebuilds / buildSeconds : 0.0;
+    if (retained != (config.jobThreads > 0)) {
+        buildScene(scene, entry, retained ? config : batchConfig);
+    }
+    scene.shapes.jobs = config.jobs;
+
+    OffscreenTarget target;
+    if (!createOffscreenTarget(target, config.width, config.height)) return false;
+    SoftRasterizer raster;
+    if (config.soft && !createSoftRasterizer(raster, config.width, config.height, config.threads)) {
+        deleteOffscreenTarget(target);
+        return false;
+    }
+
+    scene.batch.vertexFormat = config.vertexFormat;
+    scene.shapes.vertexFormat = config.vertexFormat;
+    scene.stream.vertexFormat = config.vertexFormat;
+    scene.squareMesh.vertexFormat = config.vertexFormat;
+    if (config.stream) {
+        scene.stream.allowPersistent = config.streamPersistent;
+        if (!createStreamBatch(scene.stream, result.vertices * config.vertexFormat->stride, result.indices * sizeof(unsigned int))) {
+            deleteOffscreenTarget(target);
+            return false;
+        }
+        result.streamMode = scene.stream.vertices.persistent ? "persistent" : "map";
+    } else if (retained) {
+        flushShapeList(scene.shapes);
+        result.vertexBytes = scene.shapes.vertexBytes;
+        result.indexBytes = scene.shapes.indexBytes;
+        result.uploadedVertices = scene.shapes.vertices.size() / 5;
+        scene.shapes.stats = ShapeListStats();
+    } else {
+        uploadBatch(scene.batch);
+        result.vertexBytes = scene.batch.vertexBytes;
+        result.indexBytes = scene.batch.indexBytes;
+        result.uploadedVertices = scene.batch.optimizeReport.verticesAfter;
+        result.acmrBefore = scene.batch.optimizeReport.acmrBefore;
+        result.acmrAfter = scene.batch.optimizeReport.acmrAfter;
+    }
+    if (!scene.squares.empty()) {
+        createInstancedMesh(scene.squareMesh, unitSquareMesh);
+        uploadInstances(scene.squareMesh, scene.squares.data(), scene.squares.size());
+    }
+    result.sdfShapes = scene.sdfShapes.size();
+    // only built when used, so non-SDF runs do not pay its compile and link
+    GLuint sdfProgram = 0;
+    if (!scene.sdfShapes.empty()) {
+        sdfProgram = createSdfShaderProgram();
+        createSdfBatch(scene.sdfBatch);
+        uploadSdfShapes(scene.sdfBatch, scene.sdfShapes.data(), scene.sdfShapes.size());
+    }
+
+    FrameStats stats;
+    initFrameStats(stats, NULL, 0);
+    stats.window = config.frames;
+
+    // setup staging is done with; the timed frames start from an empty arena
+    resetArena(frameArena());
+    frameArena().peak = 0;
+
+    glFinish();
+    resetGLStateCounters();
+    long long heapStart = 0;
+    start = std::chrono::steady_clock::now();
+    unsigned int seed = 1;
+    for (int frame = 0; frame < config.frames; frame++) {
+        beginFrameStats(stats);
+        if (retained) {
+            moveDirtyShapes(scene.shapes, config.dirtyPercent, frame, seed);
+            flushShapeList(scene.shapes);
+        }
+        if (config.stream) {
+            buildScene(scene, entry, batchConfig);
+            streamShapes(scene.stream, scene.batch.vertices, scene.batch.indices);
+        }
+        if (config.soft) {
+            drawSoft(raster, scene);
+        } else {
+            drawGL(scene, target, shaderProgram, instancedProgram, sdfProgram);
+        }
+        if (config.stream) endStreamBatchFrame(scene.stream);
+        endFrameStats(stats);
+        resetArena(frameArena());
+        // the first frame still sizes histories and has the driver compile on first use
+        if (frame == 0) heapStart = heapAllocationCount();
+    }
+    if (config.frames > 1) result.heapAllocsPerFrame = (double)(heapAllocationCount() - heapStart) / (config.frames - 1);
+    result.frameArenaPeak = frameArena().peak;
+    glFinish();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    GLStateCounters state = glStateCounters();
+    result.stateCalls = state.issued;
+    result.stateSkipped = state.skipped;
+    result.uploadBytesPerFrame = (double)scene.shapes.stats.uploadedBytes / config.frames;
+    result.uploadRangesPerFrame = (double)scene.shapes.stats.rangeUploads / config.frames;
+    if (config.stream) {
+        result.vertexBytes = scene.stream.vertexBytes;
+        result.indexBytes = scene.stream.indexBytes;
+        result.streamWaits = scene.stream.vertices.stats.waits + scene.stream.indices.stats.waits;
+        result.streamWaitMs = scene.stream.vertices.stats.waitMs + scene.stream.indices.stats.waitMs;
+    }
+
+    if (config.soft) {
+        // same frame through GL for the accuracy check
+        std::vector<unsigned char> reference;
+        drawGL(scene, target, shaderProgram, instancedProgram, sdfProgram);
+        readOffscreenPixels(target, reference);
+        for (size_t i = 0; i < reference.size(); i += 4) {
+            int diff = 0;
+            for (int k = 0; k < 3; k++) diff = std::max(diff, std::abs(reference[i + k] - raster.pixels[i + k]));
+            result.softMaxDiff = std::max(result.softMaxDiff, diff);
+            if (diff > SOFT_TOLERANCE) result.softDiffPixels++;
+        }
+        deleteSoftRasterizer(raster);
+    }
+
+    result.drawCalls = stats.lastDraws;
+    result.cpu = cpuFramePercentiles(stats);
+    finishFrameStats(stats);
+    result.gpu = gpuFramePercentiles(stats);
+
+    deleteBatch(scene.batch);
+    deleteShapeList(scene.shapes);
+    if (config.stream) deleteStreamBatch(scene.stream);
+    if (!scene.squares.empty()) deleteInstancedMesh(scene.squareMesh);
+    if (!scene.sdfShapes.empty()) deleteSdfBatch(scene.sdfBatch);
+    deleteOffscreenTarget(target);
+    resetArena(frameArena());
+    resetArena(sceneArena());
+    return true;
+}
+
+// points std::cout at stderr for its lifetime; saved is the real stdout
+struct StdoutToStderr {
+    std::streambuf* saved;
+    StdoutToStderr() : saved(std::cout.rdbuf(std::cerr.rdbuf())) {}
+    ~StdoutToStderr() { std::cout.rdbuf(saved); }
+};
+
+static void printUsage() {
+    std::cout << "usage: opengl --benchmark [--scene triangle|square|part1|part2|all] [--copies N] [--segments M]\n"
+                 "                 [--squares K] [--frames F] [--rebuilds R] [--size WxH]\n"
+                 "                 [--vertex-format float|packed] [--shapes mesh|sdf] [--lod E]\n"
+                 "                 [--backend gl|soft] [--threads T] [--dirty P] [--stream persistent|map]\n"
+                 "                 [--jobs T] [--csv]" << std::endl;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (arg == "--csv") { config.csv = true; continue; }
+        if (arg == "--help") { config.help = true; return true; }
+        if (value == NULL) return false;
+
+        if (arg == "--scene") config.scene = value;
+        else if (arg == "--copies") config.copies = std::max(1, atoi(value));
+        else if (arg == "--segments") config.segments = std::max(3, atoi(value));
+        else if (arg == "--squares") config.squares = std::max(0, atoi(value));
+        else if (arg == "--frames") config.frames = std::max(1, atoi(value));
+        else if (arg == "--rebuilds") config.rebuilds = std::max(1, atoi(value));
+        else if (arg == "--vertex-format") {
+            config.vertexFormat = findVertexFormat(value);
+            if (config.vertexFormat == NULL) return false;
+        }
+        else if (arg == "--lod") config.lodError = (float)atof(value);
+        else if (arg == "--threads") config.threads = atoi(value);
+        else if (arg == "--jobs") config.jobThreads = std::max(1, atoi(value));
+        else if (arg == "--dirty") config.dirtyPercent = std::min(100.0f, std::max(0.0f, (float)atof(value)));
+        else if (arg == "--backend") {
+            if (strcmp(value, "soft") == 0) config.soft = true;
+            else if (strcmp(value, "gl") == 0) config.soft = false;
+            else return false;
+        }
+        else if (arg == "--stream") {
+            config.stream = true;
+            if (strcmp(value, "persistent") == 0) config.streamPersistent = true;
+            else if (strcmp(value, "map") == 0) config.streamPersistent = false;
+            else return false;
+        }
+        else if (arg == "--shapes") {
+            if (strcmp(value, "sdf") == 0) config.sdf = true;
+            else if (strcmp(value, "mesh") == 0) config.sdf = false;
+            else return false;
+        }
+        else if (arg == "--size") {
+            if (sscanf(value, "%dx%d", &config.width, &config.height) != 2) return false;
+        }
+        else return false;
+        i++;
+    }
+
+    // the software backend only rasterizes the triangle lists of the batch
+    if (config.soft && (config.sdf || config.dirtyPercent >= 0.0f || config.stream)) {
+        std::cout << "ERROR::BENCHMARK::UNSUPPORTED --backend soft renders the mesh batch only, not --shapes sdf, --dirty or --stream" << std::endl;
+        return false;
+    }
+    // both own the tessellated shapes
+    if (config.stream && config.dirtyPercent >= 0.0f) {
+        std::cout << "ERROR::BENCHMARK::UNSUPPORTED --stream and --dirty cannot be combined" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int benchmark_main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage();
+        return -1;
+    }
+    if (config.help) {
+        printUsage();
+        return 0;
+    }
+
+    // stdout carries only the records; everything else printed during the run, here or in the
+    // modules the benchmark drives, goes to stderr so JSON-lines/CSV consumers can read stdout as is
+    StdoutToStderr redirect;
+    std::ostream records(redirect.saved);
+
+    GLFWwindow* window = createHeadlessContext();
+    if (window == NULL) {
+        return -1;
+    }
+
+    // binaries from an earlier run would hide cold compile cost differences, keep it in-process only
+    setProgramCacheDirectory("");
+    GLuint shaderProgram = createShaderProgram();
+    GLuint instancedProgram = createInstancedShaderProgram();
+
+    JobSystem jobs;
+    if (config.jobThreads > 1) {
+        createJobSystem(jobs, config.jobThreads);
+        config.jobs = &jobs;
+    }
+
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    // accuracy of the ring kernel this build uses; steps of 2^-10 keep every angle exact in float
+    double kernelError = ringSinCosMaxError(defaultSinCosPath(), -1000.0f, 1.0f / 1024.0f, 2000 * 1024);
+
+    if (config.csv) {
+        records << "scene,backend,copies,segments,lod_error,squares,width,height,frames,vertex_format,vertices,uploaded_vertices,vertex_bytes,indices,index_bytes,acmr_before,acmr_after,sdf_shapes,soft_max_diff,soft_diff_pixels,draw_calls,state_calls,state_skipped,"
+                     "dirty_percent,upload_bytes_per_frame,upload_ranges_per_frame,stream,stream_waits,stream_wait_ms,"
+                     "heap_allocs_per_frame,frame_arena_peak,"
+                     "fps,cpu_ms_p50,cpu_ms_p95,cpu_ms_p99,gpu_ms_p50,gpu_ms_p95,gpu_ms_p99,gpu_samples,tess_vertices_per_sec,tess_threads" << std::endl;
+    } else {
+        const GLLoaderReport& loader = glLoaderReport();
+        records << "{\"renderer\":\"" << (renderer ? renderer : "") << "\",\"gl_functions\":" << loader.resolved
+                  << ",\"gl_load_ms\":" << loader.milliseconds << ",\"sincos_max_abs_error\":" << kernelError << "}" << std::endl;
+    }
+
+    int failures = 0;
+    for (const BenchEntry& entry : entries) {
+        if (config.scene != "all" && config.scene != entry.name) continue;
+
+        BenchResult result;
+        if (!runBenchmark(entry, config, shaderProgram, instancedProgram, result)) {
+            std::cerr << "Failed to run " << entry.name << std::endl;
+            failures++;
+            continue;
+        }
+
+        double fps = result.seconds > 0.0 ? config.frames / result.seconds : 0.0;
+        if (config.csv) {
+            records << entry.name << "," << (config.soft ? "soft" : "gl") << "," << config.copies << "," << config.segments << "," << config.lodError << "," << config.squares << ","
+                      << config.width << "," << config.height << "," << config.frames << ","
+                      << config.vertexFormat->name << "," << result.vertices << "," << result.uploadedVertices << "," << result.vertexBytes << ","
+                      << result.indices << "," << result.indexBytes << "," << result.acmrBefore << "," << result.acmrAfter << "," << result.sdfShapes << "," << result.softMaxDiff << "," << result.softDiffPixels << "," << result.drawCalls << "," << result.stateCalls << "," << result.stateSkipped << ","
+                      << config.dirtyPercent << "," << result.uploadBytesPerFrame << "," << result.uploadRangesPerFrame << ","
+                      << result.streamMode << "," << result.streamWaits << "," << result.streamWaitMs << ","
+                      << result.heapAllocsPerFrame << "," << result.frameArenaPeak << ","
+                      << fps << "," << result.cpu.p50 << "," << result.cpu.p95 << "," << result.cpu.p99 << ","
+                      << result.gpu.p50 << "," << result.gpu.p95 << "," << result.gpu.p99 << "," << result.gpu.samples << ","
+                      << result.tessVerticesPerSecond << "," << config.jobThreads << std::endl;
+        } else {
+            records << "{\"scene\":\"" << entry.name << "\",\"backend\":\"" << (config.soft ? "soft" : "gl") << "\""
+                      << ",\"copies\":" << config.copies
+                      << ",\"segments\":" << config.segments << ",\"lod_error\":" << config.lodError << ",\"squares\":" << config.squares
+                      << ",\"width\":" << config.width << ",\"height\":" << config.height
+                      << ",\"frames\":" << config.frames << ",\"vertex_format\":\"" << config.vertexFormat->name << "\""
+                      << ",\"vertices\":" << result.vertices << ",\"uploaded_vertices\":" << result.uploadedVertices
+                      << ",\"vertex_bytes\":" << result.vertexBytes
+                      << ",\"indices\":" << result.indices << ",\"index_bytes\":" << result.indexBytes
+                      << ",\"acmr\":{\"before\":" << result.acmrBefore << ",\"after\":" << result.acmrAfter << "}"
+                      << ",\"sdf_shapes\":" << result.sdfShapes
+                      << ",\"soft_max_diff\":" << result.softMaxDiff << ",\"soft_diff_pixels\":" << result.softDiffPixels << ",\"draw_calls\":" << result.drawCalls
+                      << ",\"state_calls\":" << result.stateCalls << ",\"state_skipped\":" << result.stateSkipped
+                      << ",\"dirty_percent\":" << config.dirtyPercent << ",\"upload_bytes_per_frame\":" << result.uploadBytesPerFrame
+                      << ",\"upload_ranges_per_frame\":" << result.uploadRangesPerFrame
+                      << ",\"stream\":\"" << result.streamMode << "\",\"stream_waits\":" << result.streamWaits << ",\"stream_wait_ms\":" << result.streamWaitMs
+                      << ",\"heap_allocs_per_frame\":" << result.heapAllocsPerFrame << ",\"frame_arena_peak\":" << result.frameArenaPeak
+                      << ",\"fps\":" << fps
+                      << ",\"cpu_ms\":{\"p50\":" << result.cpu.p50 << ",\"p95\":" << result.cpu.p95 << ",\"p99\":" << result.cpu.p99 << "}"
+                      << ",\"gpu_ms\":{\"p50\":" << result.gpu.p50 << ",\"p95\":" << result.gpu.p95 << ",\"p99\":" << result.gpu.p99 << ",\"samples\":" << result.gpu.samples << "}"
+                      << ",\"tess_vertices_per_sec\":" << result.tessVerticesPerSecond << ",\"tess_threads\":" << config.jobThreads << "}" << std::endl;
+        }
+
+        if (config.soft && result.softDiffPixels > 0) {
+            std::cerr << "ERROR::BENCHMARK::SOFT_MISMATCH " << entry.name << ": " << result.softDiffPixels
+                      << " pixels differ from GL by more than " << SOFT_TOLERANCE << std::endl;
+            failures++;
+        }
+    }
+
+    deleteCachedPrograms();
+    if (config.jobs) deleteJobSystem(jobs);
+    glfwTerminate();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include "frame_pacing.h"
+#include <iostream>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+static double millisecondsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static Clock::duration fromMilliseconds(double ms) {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+}
+
+const char* vsyncModeName(VsyncMode mode) {
+    switch (mode) {
+    case VSYNC_OFF: return "off";
+    case VSYNC_ADAPTIVE: return "adaptive";
+    default: return "on";
+    }
+}
+
+void initFramePacing(FramePacing& pacing, VsyncMode vsync, double targetFps) {
+    if (vsync == VSYNC_ADAPTIVE && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cout << "WARNING::FRAME_PACING::NO_ADAPTIVE_VSYNC falling back to on" << std::endl;
+        vsync = VSYNC_ON;
+    }
+
+    pacing.vsync = vsync;
+    pacing.targetFps = std::max(0.0, targetFps);
+    glfwSwapInterval(vsync == VSYNC_OFF ? 0 : vsync == VSYNC_ADAPTIVE ? -1 : 1);
+
+#ifdef _WIN32
+    // 1 ms sleep granularity instead of the default timer tick, undone in finishFramePacing
+    if (pacing.targetFps > 0.0) timeBeginPeriod(1);
+#endif
+
+    pacing.deadline = pacing.lastPresent = Clock::now();
+    pacing.frames = 0;
+    pacing.intervalSum = pacing.intervalSquares = 0.0;
+    pacing.missedDeadlines = 0;
+}
+
+void initFramePacingFromEnv(FramePacing& pacing) {
+    const char* vsync = getenv("VSYNC");
+    const char* limit = getenv("FPS_LIMIT");
+    const char* stats = getenv("FRAME_STATS");
+
+    VsyncMode mode = VSYNC_ON;
+    if (vsync && *vsync) {
+        if (strcmp(vsync, "off") == 0 || strcmp(vsync, "0") == 0) mode = VSYNC_OFF;
+        else if (strcmp(vsync, "adaptive") == 0) mode = VSYNC_ADAPTIVE;
+        else if (strcmp(vsync, "on") != 0 && strcmp(vsync, "1") != 0) {
+            std::cout << "WARNING::FRAME_PACING::UNKNOWN_VSYNC " << vsync << std::endl;
+        }
+    }
+
+    initFramePacing(pacing, mode, (limit && *limit) ? atof(limit) : 0.0);
+    pacing.report = (vsync && *vsync) || (limit && *limit) || (stats && *stats && *stats != '0');
+}
+
+// sleeps most of the way to the deadline and spins the rest
+static void waitUntil(FramePacing& pacing, Clock::time_point deadline) {
+    Clock::time_point now = Clock::now();
+    double remainingMs = millisecondsBetween(now, deadline);
+
+    if (remainingMs > pacing.spinMs) {
+        Clock::time_point wake = deadline - fromMilliseconds(pacing.spinMs);
+        std::this_thread::sleep_until(wake);
+
+        // worst recent oversleep, decaying so one bad wake-up does not widen the window forever
+        double oversleep = std::max(0.0, millisecondsBetween(wake, Clock::now()));
+        pacing.oversleepMs = std::max(oversleep, pacing.oversleepMs * 0.95);
+        pacing.spinMs = std::min(PACING_MAX_SPIN_MS, std::max(PACING_MIN_SPIN_MS, pacing.oversleepMs * 1.25));
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void presentFrame(FramePacing& pacing, GLFWwindow* window) {
+    if (pacing.targetFps > 0.0) {
+        Clock::duration period = fromMilliseconds(1000.0 / pacing.targetFps);
+        pacing.deadline += period;
+
+        // more than a frame behind: start over from now rather than rush to catch up
+        Clock::time_point now = Clock::now();
+        if (pacing.deadline < now) {
+            pacing.missedDeadlines++;
+            if (now - pacing.deadline > period) pacing.deadline = now;
+        }
+        waitUntil(pacing, pacing.deadline);
+    }
+
+    glfwSwapBuffers(window);
+
+    Clock::time_point present = Clock::now();
+    double interval = millisecondsBetween(pacing.lastPresent, present);
+    pacing.lastPresent = present;
+    if (pacing.frames++ > 0) {
+        pacing.intervalSum += interval;
+        pacing.intervalSquares += interval * interval;
+        pacing.intervalMin = (pacing.frames == 2) ? interval : std::min(pacing.intervalMin, interval);
+        pacing.intervalMax = std::max(pacing.intervalMax, interval);
+    }
+
+    glfwPollEvents();
+}
+
+double frameJitterMs(const FramePacing& pacing) {
+    long long count = pacing.frames - 1;
+    if (count < 2) return 0.0;
+
+    double mean = pacing.intervalSum / count;
+    return std::sqrt(std::max(0.0, pacing.intervalSquares / count - mean * mean));
+}
+
+void finishFramePacing(FramePacing& pacing) {
+#ifdef _WIN32
+    if (pacing.targetFps > 0.0) timeEndPeriod(1);
+#endif
+    if (!pacing.report || pacing.frames < 2) return;
+
+    long long count = pacing.frames - 1;
+    double mean = pacing.intervalSum / count;
+    std::cout << "frame pacing: vsync " << vsyncModeName(pacing.vsync) << ", limit ";
+    if (pacing.targetFps > 0.0) std::cout << pacing.targetFps << " fps";
+    else std::cout << "off";
+    std::cout << " | " << (mean > 0.0 ? 1000.0 / mean : 0.0) << " fps, interval ms mean " << mean
+              << " min " << pacing.intervalMin << " max " << pacing.intervalMax
+              << " jitter " << frameJitterMs(pacing);
+    if (pacing.targetFps > 0.0) {
+        std::cout << " | missed " << pacing.missedDeadlines << ", spin window " << pacing.spinMs << " ms";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,49 @@
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+#include "gl_loader.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+// presents frames: swap interval, optional frame-rate cap and present-to-present jitter
+// the cap sleeps until shortly before each deadline and spins the rest; the spin window
+// follows the worst recent oversleep within [PACING_MIN_SPIN_MS, PACING_MAX_SPIN_MS],
+// so a coarse OS timer gets a wide window and a fine one a narrow one
+#define PACING_MIN_SPIN_MS 0.25
+#define PACING_MAX_SPIN_MS 4.0
+
+enum VsyncMode {
+    VSYNC_OFF,     // swap interval 0, uncapped unless targetFps is set
+    VSYNC_ON,      // swap interval 1
+    VSYNC_ADAPTIVE // swap interval -1: tears instead of waiting a whole refresh when late
+};
+
+struct FramePacing {
+    VsyncMode vsync = VSYNC_ON;
+    double targetFps = 0.0; // > 0: frame limiter on top of the swap interval
+    bool report = false;    // summary from finishFramePacing
+
+    std::chrono::steady_clock::time_point deadline, lastPresent;
+    double spinMs = 1.0;     // spin window before the deadline
+    double oversleepMs = 0.0; // worst recent wake-up past the requested time
+
+    // present-to-present intervals, without the first frame
+    long long frames = 0;
+    double intervalSum = 0.0, intervalSquares = 0.0;
+    double intervalMin = 0.0, intervalMax = 0.0;
+    long long missedDeadlines = 0; // limiter frames that were already late
+};
+
+// needs the window's context current; adaptive falls back to on without swap_control_tear
+void initFramePacing(FramePacing& pacing, VsyncMode vsync, double targetFps);
+// VSYNC=off|on|adaptive and FPS_LIMIT=<fps>; the summary is printed when either or FRAME_STATS is set
+void initFramePacingFromEnv(FramePacing& pacing);
+
+// waits for the limiter, swaps and polls events; replaces glfwSwapBuffers + glfwPollEvents
+void presentFrame(FramePacing& pacing, GLFWwindow* window);
+void finishFramePacing(FramePacing& pacing);
+
+// standard deviation of the present interval in ms
+double frameJitterMs(const FramePacing& pacing);
+const char* vsyncModeName(VsyncMode mode);
+
+#endif
@@ -0,0 +1,238 @@
+#include "gl_loader.h"
+#include "frame_stats.h"
+#include "arena.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+
+// the frame currently between beginFrameStats/endFrameStats, if any
+static FrameStats* activeStats = NULL;
+static bool drawOpen = false;
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void resizeHistory(FrameHistory& history, size_t window) {
+    history.values.assign(window, 0.0);
+    history.next = history.count = 0;
+}
+
+static void pushHistory(FrameHistory& history, double value) {
+    size_t window = history.values.size();
+    if (window == 0) return;
+
+    history.values[history.next] = value;
+    history.next = (history.next + 1) % window;
+    history.count = std::min(history.count + 1, window);
+}
+
+static FramePercentiles percentiles(const FrameHistory& history) {
+    if (history.count == 0) return { 0.0, 0.0, 0.0, 0 };
+
+    // the ring holds count values; order does not matter once sorted
+    size_t count = history.count;
+    double* sorted = arenaArray<double>(frameArena(), count);
+    std::copy(history.values.begin(), history.values.begin() + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    // nearest rank
+    auto rank = [&](double p) { return sorted[std::min(count - 1, (size_t)(p * count))]; };
+    return { rank(0.50), rank(0.95), rank(0.99), count };
+}
+
+void initFrameStats(FrameStats& stats, const char* csvPath, int reportInterval) {
+    stats.enabled = true;
+    stats.frame = 0;
+    stats.reportInterval = reportInterval;
+
+    for (FrameStatsPending& pending : stats.pending) {
+        glGenQueries(STATS_MAX_DRAWS, pending.queries);
+        pending.frame = -1;
+    }
+
+    if (csvPath && *csvPath) {
+        stats.csv.open(csvPath, std::ios::trunc);
+        if (!stats.csv) {
+            std::cout << "Failed to open " << csvPath << std::endl;
+        } else {
+            stats.csv << "frame,cpu_ms,frame_ms,gpu_ms,draw_calls,vertices,heap_allocs,gpu_draw_ms" << std::endl;
+        }
+    }
+
+    stats.lastFrameStart = std::chrono::steady_clock::now();
+}
+
+void initFrameStatsFromEnv(FrameStats& stats) {
+    const char* print = getenv("FRAME_STATS");
+    const char* csvPath = getenv("FRAME_STATS_CSV");
+
+    bool toStdout = print && *print && *print != '0';
+    if (!toStdout && !(csvPath && *csvPath)) return;
+
+    initFrameStats(stats, csvPath, toStdout ? 120 : 0);
+}
+
+// reads back one finished frame; false if the GPU has not got there yet
+static bool collect(FrameStats& stats, FrameStatsPending& pending, bool wait) {
+    if (pending.frame < 0) return true;
+
+    if (pending.queryCount > 0 && !wait) {
+        GLint available = 0;
+        glGetQueryObjectiv(pending.queries[pending.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    double gpuMs = 0.0;
+    double drawMs[STATS_MAX_DRAWS];
+    for (int i = 0; i < pending.queryCount; i++) {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(pending.queries[i], GL_QUERY_RESULT, &ns);
+        drawMs[i] = ns / 1.0e6;
+        gpuMs += drawMs[i];
+    }
+    pushHistory(stats.gpuHistory, gpuMs);
+
+    if (stats.csv.is_open()) {
+        stats.csv << pending.frame << "," << pending.cpuMs << "," << pending.frameMs << "," << gpuMs << ","
+                  << pending.draws << "," << pending.vertices << "," << pending.heapAllocs << ",";
+        for (int i = 0; i < pending.queryCount; i++) {
+            stats.csv << (i ? ";" : "") << drawMs[i];
+        }
+        stats.csv << "\n";
+    }
+
+    pending.frame = -1;
+    return true;
+}
+
+static void printSummary(const FrameStats& stats) {
+    FramePercentiles cpu = cpuFramePercentiles(stats);
+    FramePercentiles frame = frameTimePercentiles(stats);
+    FramePercentiles gpu = gpuFramePercentiles(stats);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "frame " << stats.frame
+              << " | cpu ms p50 " << cpu.p50 << " p95 " << cpu.p95 << " p99 " << cpu.p99
+              << " | frame ms p50 " << frame.p50 << " p95 " << frame.p95 << " p99 " << frame.p99
+              << " | gpu ms (" << gpu.samples << " frames) p50 " << gpu.p50 << " p95 " << gpu.p95 << " p99 " << gpu.p99
+              << " | draws " << stats.lastDraws << " verts " << stats.lastVertices
+              << " heap allocs " << stats.lastHeapAllocs
+              << std::defaultfloat << std::endl;
+}
+
+void beginFrameStats(FrameStats& stats) {
+    if (!stats.enabled) return;
+
+    // sized here rather than in init, callers may change the window after initFrameStats
+    if (stats.cpuHistory.values.size() != stats.window) {
+        resizeHistory(stats.cpuHistory, stats.window);
+        resizeHistory(stats.frameHistory, stats.window);
+        resizeHistory(stats.gpuHistory, stats.window);
+    }
+
+    // the set reused below was issued STATS_QUERY_FRAMES frames ago and must be read now,
+    // waiting if need be; later sets are read oldest first while their results are ready
+    FrameStatsPending& pending = stats.pending[stats.frame % STATS_QUERY_FRAMES];
+    if (!collect(stats, pending, false)) {
+        stats.gpuWaits++;
+        collect(stats, pending, true);
+    }
+    for (int i = 1; i < STATS_QUERY_FRAMES; i++) {
+        if (!collect(stats, stats.pending[(stats.frame + i) % STATS_QUERY_FRAMES], false)) break;
+    }
+
+    pending.draws = 0;
+    pending.vertices = 0;
+    pending.queryCount = 0;
+
+    stats.frameStart = std::chrono::steady_clock::now();
+    pending.frameMs = std::chrono::duration<double, std::milli>(stats.frameStart - stats.lastFrameStart).count();
+    stats.lastFrameStart = stats.frameStart;
+    stats.frameHeapStart = heapAllocationCount();
+
+    activeStats = &stats;
+}
+
+void endFrameStats(FrameStats& stats) {
+    if (!stats.enabled) return;
+
+    FrameStatsPending& pending = stats.pending[stats.frame % STATS_QUERY_FRAMES];
+    if (drawOpen) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending.queryCount++;
+        drawOpen = false;
+    }
+    activeStats = NULL;
+
+    pending.frame = stats.frame;
+    pending.cpuMs = millisecondsSince(stats.frameStart);
+    pending.heapAllocs = heapAllocationCount() - stats.frameHeapStart;
+
+    pushHistory(stats.cpuHistory, pending.cpuMs);
+    if (stats.frame > 0) pushHistory(stats.frameHistory, pending.frameMs);
+    stats.lastDraws = pending.draws;
+    stats.lastVertices = pending.vertices;
+    stats.lastHeapAllocs = pending.heapAllocs;
+    stats.totalVertices += pending.vertices;
+
+    stats.frame++;
+    if (stats.reportInterval > 0 && stats.frame % stats.reportInterval == 0) {
+        printSummary(stats);
+    }
+}
+
+void finishFrameStats(FrameStats& stats) {
+    if (!stats.enabled) return;
+
+    // oldest first so CSV rows stay in frame order
+    for (int i = 0; i < STATS_QUERY_FRAMES; i++) {
+        collect(stats, stats.pending[(stats.frame + i) % STATS_QUERY_FRAMES], true);
+    }
+    if (stats.reportInterval > 0) printSummary(stats);
+    if (stats.gpuWaits > 0) {
+        std::cout << "frame stats: waited for the GPU timings of " << stats.gpuWaits << " frames" << std::endl;
+    }
+
+    for (FrameStatsPending& pending : stats.pending) {
+        glDeleteQueries(STATS_MAX_DRAWS, pending.queries);
+    }
+    if (stats.csv.is_open()) stats.csv.close();
+    stats.enabled = false;
+}
+
+void beginTimedDraw() {
+    if (!activeStats) return;
+
+    FrameStatsPending& pending = activeStats->pending[activeStats->frame % STATS_QUERY_FRAMES];
+    if (pending.queryCount < STATS_MAX_DRAWS) {
+        glBeginQuery(GL_TIME_ELAPSED, pending.queries[pending.queryCount]);
+        drawOpen = true;
+    }
+}
+
+void endTimedDraw(long long vertices) {
+    if (!activeStats) return;
+
+    FrameStatsPending& pending = activeStats->pending[activeStats->frame % STATS_QUERY_FRAMES];
+    if (drawOpen) {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending.queryCount++;
+        drawOpen = false;
+    }
+    pending.draws++;
+    pending.vertices += vertices;
+}
+
+FramePercentiles cpuFramePercentiles(const FrameStats& stats) {
+    return percentiles(stats.cpuHistory);
+}
+
+FramePercentiles frameTimePercentiles(const FrameStats& stats) {
+    return percentiles(stats.frameHistory);
+}
+
+FramePercentiles gpuFramePercentiles(const FrameStats& stats) {
+    return percentiles(stats.gpuHistory);
+}
@@ -0,0 +1,77 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+#include <chrono>
+#include <vector>
+#include <fstream>
+
+// per-frame timing: CPU frame time, GPU time of every timed draw (GL_TIME_ELAPSED),
+// draw-call and vertex counts, rolling p50/p95/p99 to stdout and one CSV row per frame
+// query sets rotate over STATS_QUERY_FRAMES frames; every frame reads the sets whose
+// results are available, oldest first, so no frame loses its GPU time; only a set still
+// unfinished when its slot comes round again is waited for, counted in gpuWaits
+// histories are fixed rings and the percentile sort uses the frame arena, so a frame
+// allocates nothing from the heap; the heap allocations inside each frame are reported
+#define STATS_QUERY_FRAMES 8
+#define STATS_MAX_DRAWS 32
+
+struct FrameStatsPending {
+    int frame = -1;
+    double cpuMs = 0.0, frameMs = 0.0;
+    int draws = 0;
+    long long vertices = 0;
+    long long heapAllocs = 0;
+    int queryCount = 0;
+    unsigned int queries[STATS_MAX_DRAWS] = {}; // GL query names
+};
+
+// the last `window` values, oldest overwritten first
+struct FrameHistory {
+    std::vector<double> values;
+    size_t next = 0, count = 0;
+};
+
+struct FramePercentiles {
+    double p50, p95, p99;
+    size_t samples; // frames the percentiles are taken over
+};
+
+struct FrameStats {
+    bool enabled = false;
+    int frame = 0;
+    int reportInterval = 120; // frames between stdout summaries, 0 = never
+    size_t window = 240;      // frames kept for the rolling percentiles
+
+    std::ofstream csv;
+    FrameStatsPending pending[STATS_QUERY_FRAMES];
+
+    std::chrono::steady_clock::time_point frameStart, lastFrameStart;
+    long long frameHeapStart = 0;
+    FrameHistory cpuHistory, frameHistory, gpuHistory;
+    int lastDraws = 0;
+    long long lastHeapAllocs = 0;
+    long long lastVertices = 0;
+    long long totalVertices = 0;
+    int gpuWaits = 0;
+};
+
+// csvPath may be NULL; needs a current GL context
+void initFrameStats(FrameStats& stats, const char* csvPath, int reportInterval);
+// enabled by FRAME_STATS=1 (stdout) and/or FRAME_STATS_CSV=<path>, otherwise every call is a no-op
+void initFrameStatsFromEnv(FrameStats& stats);
+
+void beginFrameStats(FrameStats& stats);
+void endFrameStats(FrameStats& stats);
+// waits for outstanding queries, prints the final summary and frees the queries
+void finishFrameStats(FrameStats& stats);
+
+// wrap each draw call; no-ops unless a FrameStats is between begin/end
+// vertices is what the draw reads from its vertex buffers (times instances), not its index
+// count, so the figure follows the geometry rather than the index packing
+void beginTimedDraw();
+void endTimedDraw(long long vertices);
+
+FramePercentiles cpuFramePercentiles(const FrameStats& stats);
+FramePercentiles frameTimePercentiles(const FrameStats& stats);
+FramePercentiles gpuFramePercentiles(const FrameStats& stats);
+
+#endif
@@ -0,0 +1,54 @@
+#include "gl_context.h"
+#include "gl_state.h"
+#include <iostream>
+#include <cstdlib>
+
+GLFWwindow* createGLContext(int width, int height, const char* title, bool visible) {
+    bool useOSMesa = false;
+#if !defined(_WIN32) && !defined(__APPLE__)
+    bool noDisplay = !visible && !getenv("DISPLAY") && !getenv("WAYLAND_DISPLAY");
+#if defined(GLFW_PLATFORM_NULL)
+    // no display server to talk to, render through OSMesa instead
+    if (noDisplay) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        useOSMesa = true;
+    }
+#else
+    // GLFW before 3.4 has no null platform to put OSMesa behind, glfwInit will fail
+    if (noDisplay) {
+        std::cout << "WARNING::GL_CONTEXT::NO_DISPLAY GLFW " << GLFW_VERSION_MAJOR << "." << GLFW_VERSION_MINOR
+                  << " needs a display; run under xvfb-run or build against GLFW 3.4" << std::endl;
+    }
+#endif
+#endif
+
+    if (!glfwInit()) {
+        std::cout << "Failed to initialize GLFW" << std::endl;
+        return NULL;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+    if (useOSMesa) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    }
+
+    GLFWwindow* window = glfwCreateWindow(width, height, title, NULL, NULL);
+    if (window == NULL) {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return NULL;
+    }
+    glfwMakeContextCurrent(window);
+
+    if (!loadGLFunctions((GLLoadProc)glfwGetProcAddress)) {
+        std::cout << "Failed to load OpenGL functions" << std::endl;
+        glfwTerminate();
+        return NULL;
+    }
+    resetGLState();
+
+    return window;
+}
@@ -0,0 +1,12 @@
+#ifndef GL_CONTEXT_H
+#define GL_CONTEXT_H
+#include "gl_loader.h"
+#include <GLFW/glfw3.h>
+
+// one GL 3.3 core context, made current with its functions loaded (gl_loader.h)
+// a hidden context on Linux without DISPLAY/WAYLAND_DISPLAY goes through GLFW's null
+// platform and OSMesa, so it runs on Mesa llvmpipe with no GPU or display; that platform
+// is new in GLFW 3.4, a 3.3 build needs a display (e.g. xvfb-run) and says so
+GLFWwindow* createGLContext(int width, int height, const char* title, bool visible);
+
+#endif
@@ -0,0 +1,58 @@
+#include "gl_loader.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace gl_loader {
+#define GL_LOADER_DEFINE(ret, name, args) PFN_##name name = NULL;
+GL_LOADER_CORE_FUNCTIONS(GL_LOADER_DEFINE)
+GL_LOADER_OPTIONAL_FUNCTIONS(GL_LOADER_DEFINE)
+#undef GL_LOADER_DEFINE
+}
+
+static GLLoaderReport report;
+
+bool loadGLFunctions(GLLoadProc getProcAddress) {
+    auto start = std::chrono::steady_clock::now();
+    report = GLLoaderReport();
+
+#define GL_LOADER_REQUIRED(ret, name, args) \
+    name = (PFN_##name)getProcAddress(#name); \
+    if (name) report.resolved++; \
+    else { report.missingRequired++; std::cout << "ERROR::GL_LOADER::MISSING_FUNCTION " << #name << std::endl; }
+#define GL_LOADER_OPTIONAL(ret, name, args) \
+    name = (PFN_##name)getProcAddress(#name); \
+    if (name) report.resolved++;
+    GL_LOADER_CORE_FUNCTIONS(GL_LOADER_REQUIRED)
+    GL_LOADER_OPTIONAL_FUNCTIONS(GL_LOADER_OPTIONAL)
+#undef GL_LOADER_REQUIRED
+#undef GL_LOADER_OPTIONAL
+
+    if (glGetIntegerv) {
+        glGetIntegerv(GL_MAJOR_VERSION, &report.major);
+        glGetIntegerv(GL_MINOR_VERSION, &report.minor);
+    }
+
+    report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report.missingRequired == 0;
+}
+
+const GLLoaderReport& glLoaderReport() {
+    return report;
+}
+
+bool hasGLVersion(int major, int minor) {
+    return report.major > major || (report.major == major && report.minor >= minor);
+}
+
+bool hasGLExtension(const char* name) {
+    if (!glGetStringi) return false;
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension && strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,205 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+// the project's only GL loader: GL 3.3 core types and constants plus the entry points
+// this renderer actually calls, resolved once per process by loadGLFunctions()
+// a function the code starts using must be added to one of the lists below
+// pointers live in namespace gl_loader so they never clash with the exported symbols of
+// libGL/opengl32; the using-directive keeps call sites as plain glFoo(...)
+
+#ifdef __gl_h_
+#error OpenGL header already included, gl_loader.h provides it
+#endif
+#define __gl_h_
+
+#if defined(_WIN32) && !defined(APIENTRY) && !defined(__CYGWIN__) && !defined(__SCITECH_SNAP__)
+#define APIENTRY __stdcall
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef APIENTRYP
+#define APIENTRYP APIENTRY *
+#endif
+
+#include <KHR/khrplatform.h>
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef void GLvoid;
+typedef khronos_int8_t GLbyte;
+typedef khronos_uint8_t GLubyte;
+typedef khronos_int16_t GLshort;
+typedef khronos_uint16_t GLushort;
+typedef int GLint;
+typedef unsigned int GLuint;
+typedef int GLsizei;
+typedef khronos_float_t GLfloat;
+typedef double GLdouble;
+typedef char GLchar;
+typedef khronos_intptr_t GLintptr;
+typedef khronos_ssize_t GLsizeiptr;
+typedef khronos_int64_t GLint64;
+typedef khronos_uint64_t GLuint64;
+typedef struct __GLsync *GLsync;
+
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_BLEND 0x0BE2
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_EXTENSIONS 0x1F03
+#define GL_FALSE 0
+#define GL_FLOAT 0x1406
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_LINK_STATUS 0x8B82
+#define GL_MAJOR_VERSION 0x821B
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_READ_BIT 0x0001
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MINOR_VERSION 0x821C
+#define GL_NO_ERROR 0
+#define GL_NUM_EXTENSIONS 0x821D
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_ONE_MINUS_SRC_ALPHA 0x0303
+#define GL_PACK_ALIGNMENT 0x0D05
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_PRIMITIVE_RESTART 0x8F9D
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_RENDERBUFFER 0x8D41
+#define GL_RENDERER 0x1F01
+#define GL_RGBA 0x1908
+#define GL_RGBA8 0x8058
+#define GL_SHORT 0x1402
+#define GL_SRC_ALPHA 0x0302
+#define GL_STATIC_DRAW 0x88E4
+#define GL_STREAM_DRAW 0x88E0
+#define GL_STREAM_READ 0x88E1
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_TRIANGLES 0x0004
+#define GL_TRIANGLE_FAN 0x0006
+#define GL_TRIANGLE_STRIP 0x0005
+#define GL_TRUE 1
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_INT 0x1405
+#define GL_UNSIGNED_SHORT 0x1403
+#define GL_VENDOR 0x1F00
+#define GL_VERSION 0x1F02
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_VIEWPORT 0x0BA2
+#define GL_WAIT_FAILED 0x911D
+
+// required: loading fails if the context lacks any of these
+#define GL_LOADER_CORE_FUNCTIONS(X) \
+    X(void, glAttachShader, (GLuint program, GLuint shader)) \
+    X(void, glBeginQuery, (GLenum target, GLuint id)) \
+    X(void, glBindBuffer, (GLenum target, GLuint buffer)) \
+    X(void, glBindFramebuffer, (GLenum target, GLuint framebuffer)) \
+    X(void, glBindRenderbuffer, (GLenum target, GLuint renderbuffer)) \
+    X(void, glBindVertexArray, (GLuint array)) \
+    X(void, glBlendFunc, (GLenum sfactor, GLenum dfactor)) \
+    X(void, glBufferData, (GLenum target, GLsizeiptr size, const void *data, GLenum usage)) \
+    X(void, glBufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, const void *data)) \
+    X(GLenum, glCheckFramebufferStatus, (GLenum target)) \
+    X(void, glClear, (GLbitfield mask)) \
+    X(void, glClearColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)) \
+    X(GLenum, glClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout)) \
+    X(void, glCompileShader, (GLuint shader)) \
+    X(GLuint, glCreateProgram, (void)) \
+    X(GLuint, glCreateShader, (GLenum type)) \
+    X(void, glDeleteBuffers, (GLsizei n, const GLuint *buffers)) \
+    X(void, glDeleteFramebuffers, (GLsizei n, const GLuint *framebuffers)) \
+    X(void, glDeleteProgram, (GLuint program)) \
+    X(void, glDeleteQueries, (GLsizei n, const GLuint *ids)) \
+    X(void, glDeleteRenderbuffers, (GLsizei n, const GLuint *renderbuffers)) \
+    X(void, glDeleteShader, (GLuint shader)) \
+    X(void, glDeleteSync, (GLsync sync)) \
+    X(void, glDeleteVertexArrays, (GLsizei n, const GLuint *arrays)) \
+    X(void, glDisable, (GLenum cap)) \
+    X(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count)) \
+    X(void, glDrawArraysInstanced, (GLenum mode, GLint first, GLsizei count, GLsizei instancecount)) \
+    X(void, glDrawElements, (GLenum mode, GLsizei count, GLenum type, const void *indices)) \
+    X(void, glDrawElementsBaseVertex, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex)) \
+    X(void, glDrawElementsInstanced, (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount)) \
+    X(void, glEnable, (GLenum cap)) \
+    X(void, glEnableVertexAttribArray, (GLuint index)) \
+    X(void, glEndQuery, (GLenum target)) \
+    X(GLsync, glFenceSync, (GLenum condition, GLbitfield flags)) \
+    X(void, glFinish, (void)) \
+    X(void, glFramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)) \
+    X(void, glGenBuffers, (GLsizei n, GLuint *buffers)) \
+    X(void, glGenFramebuffers, (GLsizei n, GLuint *framebuffers)) \
+    X(void, glGenQueries, (GLsizei n, GLuint *ids)) \
+    X(void, glGenRenderbuffers, (GLsizei n, GLuint *renderbuffers)) \
+    X(void, glGenVertexArrays, (GLsizei n, GLuint *arrays)) \
+    X(GLenum, glGetError, (void)) \
+    X(void, glGetIntegerv, (GLenum pname, GLint *data)) \
+    X(void, glGetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)) \
+    X(void, glGetProgramiv, (GLuint program, GLenum pname, GLint *params)) \
+    X(void, glGetQueryObjectiv, (GLuint id, GLenum pname, GLint *params)) \
+    X(void, glGetQueryObjectui64v, (GLuint id, GLenum pname, GLuint64 *params)) \
+    X(void, glGetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)) \
+    X(void, glGetShaderiv, (GLuint shader, GLenum pname, GLint *params)) \
+    X(const GLubyte *, glGetString, (GLenum name)) \
+    X(const GLubyte *, glGetStringi, (GLenum name, GLuint index)) \
+    X(void, glLinkProgram, (GLuint program)) \
+    X(void *, glMapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)) \
+    X(void, glPixelStorei, (GLenum pname, GLint param)) \
+    X(void, glPrimitiveRestartIndex, (GLuint index)) \
+    X(void, glReadPixels, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels)) \
+    X(void, glRenderbufferStorage, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height)) \
+    X(void, glShaderSource, (GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length)) \
+    X(GLboolean, glUnmapBuffer, (GLenum target)) \
+    X(void, glUseProgram, (GLuint program)) \
+    X(void, glVertexAttribDivisor, (GLuint index, GLuint divisor)) \
+    X(void, glVertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer)) \
+    X(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height))
+
+// GL 4.1 / GL_ARB_get_program_binary and GL 4.4 / GL_ARB_buffer_storage, NULL when missing
+#define GL_LOADER_OPTIONAL_FUNCTIONS(X) \
+    X(void, glBufferStorage, (GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)) \
+    X(void, glGetProgramBinary, (GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary)) \
+    X(void, glProgramBinary, (GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)) \
+    X(void, glProgramParameteri, (GLuint program, GLenum pname, GLint value))
+
+namespace gl_loader {
+#define GL_LOADER_DECLARE(ret, name, args) typedef ret (APIENTRYP PFN_##name) args; extern PFN_##name name;
+GL_LOADER_CORE_FUNCTIONS(GL_LOADER_DECLARE)
+GL_LOADER_OPTIONAL_FUNCTIONS(GL_LOADER_DECLARE)
+#undef GL_LOADER_DECLARE
+}
+using namespace gl_loader;
+
+// e.g. glfwGetProcAddress
+typedef void* (*GLLoadProc)(const char* name);
+
+struct GLLoaderReport {
+    int major = 0, minor = 0;
+    int resolved = 0;          // entry points found, optional ones included
+    int missingRequired = 0;
+    double milliseconds = 0.0; // time spent in loadGLFunctions
+};
+
+// needs a current context; false if a required entry point is missing
+bool loadGLFunctions(GLLoadProc getProcAddress);
+const GLLoaderReport& glLoaderReport();
+
+bool hasGLVersion(int major, int minor);
+bool hasGLExtension(const char* name);
+
+#endif
@@ -0,0 +1,164 @@
+#include "gl_state.h"
+#include <unordered_map>
+#include <cstddef>
+
+template <typename T>
+struct Tracked {
+    T value = T();
+    bool known = false;
+
+    // true when GL has to be told
+    bool set(const T& next) {
+        if (known && value == next) return false;
+        value = next;
+        known = true;
+        return true;
+    }
+};
+
+struct Viewport {
+    GLint x, y;
+    GLsizei width, height;
+    bool operator==(const Viewport& other) const {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+};
+
+struct BlendFunc {
+    GLenum source, destination;
+    bool operator==(const BlendFunc& other) const {
+        return source == other.source && destination == other.destination;
+    }
+};
+
+struct VertexArrayState {
+    Tracked<GLuint> elementBuffer;
+    unsigned int enabledAttribs = 0; // bits only ever set: every VAO starts with all attributes off
+};
+
+static Tracked<GLuint> program, vertexArray;
+static std::unordered_map<GLenum, Tracked<GLuint>> buffers; // every target except GL_ELEMENT_ARRAY_BUFFER
+static std::unordered_map<GLuint, VertexArrayState> vertexArrays;
+static Tracked<bool> blend, primitiveRestart;
+static Tracked<GLuint> restartIndex;
+static Tracked<BlendFunc> blendFunc;
+static Tracked<Viewport> viewport;
+static GLStateCounters counters;
+
+static bool count(bool changed) {
+    if (changed) counters.issued++;
+    else counters.skipped++;
+    return changed;
+}
+
+void resetGLState() {
+    program = vertexArray = restartIndex = Tracked<GLuint>();
+    buffers.clear();
+    vertexArrays.clear();
+    blend = primitiveRestart = Tracked<bool>();
+    blendFunc = Tracked<BlendFunc>();
+    viewport = Tracked<Viewport>();
+}
+
+void cachedUseProgram(GLuint name) {
+    if (count(program.set(name))) glUseProgram(name);
+}
+
+void cachedBindVertexArray(GLuint name) {
+    if (count(vertexArray.set(name))) glBindVertexArray(name);
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer) {
+    Tracked<GLuint>& binding = (target == GL_ELEMENT_ARRAY_BUFFER && vertexArray.known)
+                             ? vertexArrays[vertexArray.value].elementBuffer
+                             : buffers[target];
+    // with no VAO known the element binding cannot be attributed, always pass it on
+    if (target == GL_ELEMENT_ARRAY_BUFFER && !vertexArray.known) binding.known = false;
+
+    if (count(binding.set(buffer))) glBindBuffer(target, buffer);
+}
+
+void cachedEnableVertexAttribArray(GLuint index) {
+    unsigned int bit = 1u << index;
+    if (vertexArray.known) {
+        unsigned int& enabled = vertexArrays[vertexArray.value].enabledAttribs;
+        if (!count((enabled & bit) == 0)) return;
+        enabled |= bit;
+    } else {
+        counters.issued++;
+    }
+    glEnableVertexAttribArray(index);
+}
+
+static Tracked<bool>* capability(GLenum cap) {
+    switch (cap) {
+    case GL_BLEND: return &blend;
+    case GL_PRIMITIVE_RESTART: return &primitiveRestart;
+    default: return NULL;
+    }
+}
+
+void cachedEnable(GLenum cap) {
+    Tracked<bool>* state = capability(cap);
+    if (state == NULL || count(state->set(true))) glEnable(cap);
+}
+
+void cachedDisable(GLenum cap) {
+    Tracked<bool>* state = capability(cap);
+    if (state == NULL || count(state->set(false))) glDisable(cap);
+}
+
+void cachedBlendFunc(GLenum source, GLenum destination) {
+    if (count(blendFunc.set({ source, destination }))) glBlendFunc(source, destination);
+}
+
+void cachedPrimitiveRestartIndex(GLuint index) {
+    if (count(restartIndex.set(index))) glPrimitiveRestartIndex(index);
+}
+
+void cachedViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (count(viewport.set({ x, y, width, height }))) glViewport(x, y, width, height);
+}
+
+void getCachedViewport(GLint out[4]) {
+    if (!viewport.known) {
+        glGetIntegerv(GL_VIEWPORT, out);
+        viewport.set({ out[0], out[1], out[2], out[3] });
+        return;
+    }
+    out[0] = viewport.value.x;
+    out[1] = viewport.value.y;
+    out[2] = viewport.value.width;
+    out[3] = viewport.value.height;
+}
+
+void forgetProgram(GLuint name) {
+    // a deleted program stays current until replaced, but its name may be reused
+    if (program.known && program.value == name) program.known = false;
+}
+
+void forgetVertexArray(GLuint name) {
+    vertexArrays.erase(name);
+    if (vertexArray.known && vertexArray.value == name) vertexArray.value = 0;
+}
+
+void forgetBuffers(GLsizei n, const GLuint* names) {
+    for (GLsizei i = 0; i < n; i++) {
+        if (names[i] == 0) continue;
+        for (auto& entry : buffers) {
+            if (entry.second.known && entry.second.value == names[i]) entry.second.value = 0;
+        }
+        // only the bound VAO drops its attachment, the others keep a name that may be reused
+        for (auto& entry : vertexArrays) {
+            if (entry.second.elementBuffer.value == names[i]) entry.second.elementBuffer.known = false;
+        }
+    }
+}
+
+GLStateCounters glStateCounters() {
+    return counters;
+}
+
+void resetGLStateCounters() {
+    counters = GLStateCounters();
+}
@@ -0,0 +1,41 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+#include "gl_loader.h"
+
+// shadow copy of the bindings and fixed-function state the renderer touches;
+// each cached* call reaches GL only when the value differs from the last one set,
+// so per-frame rebinds of an unchanged program or VAO cost a compare
+// all code must go through these for the bound program, VAOs, buffers, enabled
+// attributes, blend, primitive restart and viewport, or the shadow copy goes stale
+// element buffer and enabled attributes are VAO state and tracked per VAO
+struct GLStateCounters {
+    long long issued = 0;  // calls passed on to GL
+    long long skipped = 0; // calls that set the current value and were dropped
+};
+
+// forgets every value, the next call of each kind reaches GL; use after a new context
+void resetGLState();
+
+void cachedUseProgram(GLuint program);
+void cachedBindVertexArray(GLuint vertexArray);
+// GL_ELEMENT_ARRAY_BUFFER is recorded against the bound VAO
+void cachedBindBuffer(GLenum target, GLuint buffer);
+void cachedEnableVertexAttribArray(GLuint index);
+// GL_BLEND and GL_PRIMITIVE_RESTART are cached, other caps pass straight through
+void cachedEnable(GLenum cap);
+void cachedDisable(GLenum cap);
+void cachedBlendFunc(GLenum source, GLenum destination);
+void cachedPrimitiveRestartIndex(GLuint index);
+void cachedViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+// last viewport set, queried from GL only when unknown
+void getCachedViewport(GLint viewport[4]);
+
+// deleting a bound object rebinds 0 in GL, call these next to glDelete*
+void forgetProgram(GLuint program);
+void forgetVertexArray(GLuint vertexArray);
+void forgetBuffers(GLsizei count, const GLuint* buffers);
+
+GLStateCounters glStateCounters();
+void resetGLStateCounters();
+
+#endif
@@ -0,0 +1,50 @@
+#include "offscreen.h"
+#include "program_cache.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+// renders every task scene once into <name>.ppm without showing a window
+// argv[0] is "--headless"; the only option is --size WxH
+int headless_main(int argc, char** argv) {
+    int width = 1024, height = 1024;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc &&
+            sscanf(argv[i + 1], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+            i++;
+            continue;
+        }
+        std::cout << "usage: opengl --headless [--size WxH]" << std::endl;
+        return -1;
+    }
+
+    GLFWwindow* window = createHeadlessContext();
+    if (window == NULL) {
+        return -1;
+    }
+
+    std::vector<unsigned char> pixels;
+    int failures = 0;
+    for (int i = 0; i < sceneCount; i++) {
+        const Scene* scene = sceneRegistry[i];
+        pixels.clear(); // a failed scene must not leave the previous image behind
+        if (!renderSceneToPixels(*scene, width, height, pixels)) {
+            std::cout << "Failed to render " << scene->name << std::endl;
+            failures++;
+            continue;
+        }
+
+        std::string path = std::string(scene->name) + ".ppm";
+        if (writePPM(path.c_str(), pixels.data(), width, height)) {
+            std::cout << "Wrote " << path << " (" << width << "x" << height << ")" << std::endl;
+        } else {
+            failures++;
+        }
+    }
+
+    deleteCachedPrograms();
+    glfwTerminate();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include "index_buffer.h"
+#include "gl_state.h"
+#include <cstring>
+
+// marks a fan boundary before the final index type is known
+#define FAN_BREAK 0xFFFFFFFFu
+
+// consecutive triangles {c, a, b}, {c, b, d}, ... collapse into one fan c, a, b, d, ...
+// rings and stars are written exactly this way, loose triangles become 3-index fans
+// fans has room for count indices; stops and returns count as soon as fans would not be shorter
+static size_t buildFans(const unsigned int* triangles, size_t count, unsigned int* fans) {
+    size_t t = 0, n = 0;
+    while (t + 2 < count) {
+        if (n + 4 > count) return count;
+        if (n > 0) fans[n++] = FAN_BREAK;
+
+        unsigned int center = triangles[t], last = triangles[t + 2];
+        fans[n++] = center;
+        fans[n++] = triangles[t + 1];
+        fans[n++] = last;
+        t += 3;
+
+        while (t + 2 < count && triangles[t] == center && triangles[t + 1] == last) {
+            if (n + 1 > count) return count;
+            last = triangles[t + 2];
+            fans[n++] = last;
+            t += 3;
+        }
+    }
+    return n;
+}
+
+size_t indexSize(GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE: return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    default: return 4;
+    }
+}
+
+GLuint restartIndex(GLenum type) {
+    switch (type) {
+    case GL_UNSIGNED_BYTE: return 0xFFu;
+    case GL_UNSIGNED_SHORT: return 0xFFFFu;
+    default: return 0xFFFFFFFFu;
+    }
+}
+
+template <typename T>
+static void narrow(const unsigned int* indices, size_t count, unsigned char* data) {
+    T* out = (T*)data;
+    for (size_t i = 0; i < count; i++) {
+        // FAN_BREAK truncates to the all-ones restart value of T
+        out[i] = (T)indices[i];
+    }
+}
+
+void packIndices(const unsigned int* triangles, size_t count, Arena& arena, PackedIndices& packed) {
+    unsigned int maxIndex = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (triangles[i] > maxIndex) maxIndex = triangles[i];
+    }
+
+    // the all-ones value stays free for primitive restart in every type
+    IndexFormat format;
+    if (maxIndex < 0xFFu) format.type = GL_UNSIGNED_BYTE;
+    else if (maxIndex < 0xFFFFu) format.type = GL_UNSIGNED_SHORT;
+    else format.type = GL_UNSIGNED_INT;
+
+    unsigned int* fans = arenaArray<unsigned int>(arena, count);
+    size_t fanCount = buildFans(triangles, count, fans);
+
+    const unsigned int* source = triangles;
+    size_t sourceCount = count;
+    if (fanCount < count) {
+        format.mode = GL_TRIANGLE_FAN;
+        format.restart = true;
+        source = fans;
+        sourceCount = fanCount;
+    }
+
+    packed.bytes = sourceCount * indexSize(format.type);
+    packed.data = arenaArray<unsigned char>(arena, packed.bytes);
+    switch (format.type) {
+    case GL_UNSIGNED_BYTE: narrow<unsigned char>(source, sourceCount, packed.data); break;
+    case GL_UNSIGNED_SHORT: narrow<unsigned short>(source, sourceCount, packed.data); break;
+    default:
+        if (sourceCount > 0) memcpy(packed.data, source, packed.bytes);
+        break;
+    }
+
+    packed.format = format;
+    packed.count = (GLsizei)sourceCount;
+}
+
+// restart is set for every draw rather than restored after it, so back-to-back fan draws
+// leave it alone; other glDrawElements callers never reach the all-ones index
+static void applyRestart(const IndexFormat& format) {
+    if (format.restart) {
+        cachedEnable(GL_PRIMITIVE_RESTART);
+        cachedPrimitiveRestartIndex(restartIndex(format.type));
+    } else {
+        cachedDisable(GL_PRIMITIVE_RESTART);
+    }
+}
+
+void drawIndexed(const IndexFormat& format, GLsizei count, GLsizei instanceCount) {
+    applyRestart(format);
+
+    if (instanceCount == 1) {
+        glDrawElements(format.mode, count, format.type, 0);
+    } else {
+        glDrawElementsInstanced(format.mode, count, format.type, 0, instanceCount);
+    }
+}
+
+void drawIndexedBaseVertex(const IndexFormat& format, GLsizei count, size_t indexOffset, GLint baseVertex) {
+    // the restart index is compared before baseVertex is added
+    applyRestart(format);
+    glDrawElementsBaseVertex(format.mode, count, format.type, (void*)indexOffset, baseVertex);
+}
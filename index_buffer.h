@@ -0,0 +1,35 @@
+#ifndef INDEX_BUFFER_H
+#define INDEX_BUFFER_H
+#include "gl_loader.h"
+#include <cstddef>
+#include "arena.h"
+
+// element buffer layout chosen at upload time
+// shapes are built as plain triangle lists of unsigned int; on the GPU the list
+// becomes triangle fans joined by primitive restart when that is shorter, stored
+// in the narrowest index type whose all-ones value is above every vertex index
+struct IndexFormat {
+    GLenum mode = GL_TRIANGLES;    // GL_TRIANGLES or GL_TRIANGLE_FAN
+    GLenum type = GL_UNSIGNED_INT; // GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    bool restart = false;          // fans are separated by restartIndex(type)
+};
+
+// data lives in the arena passed to packIndices
+struct PackedIndices {
+    unsigned char* data = NULL;
+    size_t bytes = 0;
+    IndexFormat format;
+    GLsizei count = 0;
+};
+
+void packIndices(const unsigned int* triangles, size_t count, Arena& arena, PackedIndices& packed);
+
+size_t indexSize(GLenum type);
+GLuint restartIndex(GLenum type);
+
+// glDrawElements(Instanced) with the matching mode, type and restart state
+void drawIndexed(const IndexFormat& format, GLsizei count, GLsizei instanceCount);
+// single instance starting indexOffset bytes into the EBO, every index shifted by baseVertex
+void drawIndexedBaseVertex(const IndexFormat& format, GLsizei count, size_t indexOffset, GLint baseVertex);
+
+#endif
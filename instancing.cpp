@@ -0,0 +1,92 @@
+#include "instancing.h"
+#include "gl_state.h"
+#include "frame_stats.h"
+#include "mesh_optimizer.h"
+#include <vector>
+
+void createInstancedMesh(InstancedMesh& mesh, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
+    glGenBuffers(1, &mesh.EBO);
+    glGenBuffers(1, &mesh.instanceVBO);
+
+    cachedBindVertexArray(mesh.VAO);
+
+    std::vector<float> optimizedVertices(vertices, vertices + vertexCount * 5);
+    std::vector<unsigned int> optimizedIndices(indices, indices + indexCount);
+    optimizeMesh(optimizedVertices, optimizedIndices, NULL);
+
+    Arena& arena = frameArena();
+    size_t optimizedCount = optimizedVertices.size() / 5;
+    size_t vertexBytes = optimizedCount * mesh.vertexFormat->stride;
+    unsigned char* encoded = arenaArray<unsigned char>(arena, vertexBytes);
+    encodeVertices(*mesh.vertexFormat, optimizedVertices.data(), optimizedCount, encoded);
+    cachedBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, encoded, GL_STATIC_DRAW);
+    PackedIndices packed;
+    packIndices(optimizedIndices.data(), optimizedIndices.size(), arena, packed);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, packed.bytes, packed.data, GL_STATIC_DRAW);
+    applyVertexFormat(*mesh.vertexFormat);
+
+    // per-instance attributes advance once per instance
+    cachedBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, centerX));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, scaleX));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, rotation));
+    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+    for (GLuint location = 2; location <= 5; location++) {
+        cachedEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    cachedBindVertexArray(0);
+
+    mesh.vertexCount = (GLsizei)optimizedCount;
+    mesh.indexFormat = packed.format;
+    mesh.indexCount = packed.count;
+    mesh.instanceCount = 0;
+}
+
+static constexpr RingShape unitSquare = { 0.0f, 0.0f, 1.0f, 1.0f, (float)(BAKED_PI / 4), 4,
+                                          { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, GRADIENT_LINEAR };
+constexpr BakedMesh<5, 12> unitSquareMesh = bakeRing<unitSquare.segments>(unitSquare);
+
+void createUnitRingMesh(InstancedMesh& mesh, int segments, float startAngle) {
+    Color white = { 1.0f, 1.0f, 1.0f };
+    RingShape ring = makeRegularPolygon(0.0f, 0.0f, 1.0f, segments, white, white, white);
+    ring.startAngle = startAngle;
+
+    MeshSize size = ringSize(ring);
+    float* vertices = arenaArray<float>(frameArena(), size.vertices * 5);
+    unsigned int* indices = arenaArray<unsigned int>(frameArena(), size.indices);
+    writeRing(ring, vertices, indices, 0);
+
+    createInstancedMesh(mesh, vertices, size.vertices, indices, size.indices);
+}
+
+void uploadInstances(InstancedMesh& mesh, const Instance* instances, size_t count) {
+    cachedBindBuffer(GL_ARRAY_BUFFER, mesh.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(Instance), instances, GL_DYNAMIC_DRAW);
+    mesh.instanceCount = (GLsizei)count;
+}
+
+void drawInstanced(const InstancedMesh& mesh) {
+    beginTimedDraw();
+    cachedBindVertexArray(mesh.VAO);
+    drawIndexed(mesh.indexFormat, mesh.indexCount, mesh.instanceCount);
+    endTimedDraw((long long)mesh.vertexCount * mesh.instanceCount);
+}
+
+void deleteInstancedMesh(InstancedMesh& mesh) {
+    forgetVertexArray(mesh.VAO);
+    forgetBuffers(1, &mesh.VBO);
+    forgetBuffers(1, &mesh.EBO);
+    forgetBuffers(1, &mesh.instanceVBO);
+    glDeleteVertexArrays(1, &mesh.VAO);
+    glDeleteBuffers(1, &mesh.VBO);
+    glDeleteBuffers(1, &mesh.EBO);
+    glDeleteBuffers(1, &mesh.instanceVBO);
+    mesh.VAO = mesh.VBO = mesh.EBO = mesh.instanceVBO = 0;
+    mesh.indexCount = mesh.instanceCount = 0;
+}
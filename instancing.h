@@ -0,0 +1,46 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+#include "gl_loader.h"
+#include <cstddef>
+#include "shapes.h"
+#include "baked_shapes.h"
+#include "index_buffer.h"
+#include "vertex_format.h"
+
+// one unit mesh drawn many times with glDrawElementsInstanced
+// per-instance data feeds locations 2-5 of the instanced shader (see createInstancedShaderProgram)
+struct Instance {
+    float centerX, centerY;
+    float scaleX, scaleY;
+    float rotation;
+    Color color; // multiplied with the unit mesh vertex colour
+};
+
+// vertexFormat is read by createInstancedMesh
+struct InstancedMesh {
+    const VertexFormat* vertexFormat = &floatVertexFormat;
+    GLuint VAO = 0, VBO = 0, EBO = 0, instanceVBO = 0;
+    IndexFormat indexFormat;
+    GLsizei vertexCount = 0; // after the optimizer
+    GLsizei indexCount = 0;
+    GLsizei instanceCount = 0;
+};
+
+void createInstancedMesh(InstancedMesh& mesh, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+
+template <int V, int I>
+void createInstancedMesh(InstancedMesh& mesh, const BakedMesh<V, I>& baked) {
+    createInstancedMesh(mesh, baked.vertices, V, baked.indices, I);
+}
+
+// white unit ring (radius 1 at the origin), e.g. 4 sides at pi/4 for the nested squares
+void createUnitRingMesh(InstancedMesh& mesh, int segments, float startAngle);
+
+// that square, corners at pi/4, 3pi/4, ..., baked at compile time
+extern const BakedMesh<5, 12> unitSquareMesh;
+
+void uploadInstances(InstancedMesh& mesh, const Instance* instances, size_t count);
+void drawInstanced(const InstancedMesh& mesh);
+void deleteInstancedMesh(InstancedMesh& mesh);
+
+#endif
@@ -0,0 +1,107 @@
+#include "job_system.h"
+#include <algorithm>
+
+// own jobs from the back, then steal from the front of the next deques in turn
+static bool takeJob(JobSystem& jobs, int self, Job& job) {
+    for (int k = 0; k < jobs.threadCount; k++) {
+        JobQueue& queue = jobs.queues[(self + k) % jobs.threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+
+        if (k == 0) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+        } else {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            jobs.stealCount++;
+        }
+        jobs.queued--;
+        return true;
+    }
+    return false;
+}
+
+static void runJob(JobSystem& jobs, const Job& job) {
+    job.run(job.begin, job.end, job.user);
+    jobs.jobCount++;
+    job.pending->fetch_sub(1, std::memory_order_release);
+}
+
+static void workerLoop(JobSystem* jobs, int self) {
+    for (;;) {
+        Job job;
+        if (takeJob(*jobs, self, job)) {
+            runJob(*jobs, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(jobs->sleepMutex);
+        jobs->wake.wait(lock, [&] { return jobs->quit || jobs->queued > 0; });
+        if (jobs->quit) return;
+    }
+}
+
+void createJobSystem(JobSystem& jobs, int threads) {
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    jobs.threadCount = threads;
+    jobs.queues.reset(new JobQueue[threads]);
+    jobs.queued = 0;
+    jobs.quit = false;
+    for (int i = 1; i < threads; i++) {
+        jobs.workers.emplace_back(workerLoop, &jobs, i);
+    }
+}
+
+void deleteJobSystem(JobSystem& jobs) {
+    {
+        std::lock_guard<std::mutex> lock(jobs.sleepMutex);
+        jobs.quit = true;
+    }
+    jobs.wake.notify_all();
+    for (std::thread& worker : jobs.workers) worker.join();
+    jobs.workers.clear();
+    jobs.queues.reset();
+    jobs.threadCount = 1;
+}
+
+void parallelFor(JobSystem* jobs, size_t count, size_t grain, JobFunction run, void* user) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    if (jobs == NULL || jobs->threadCount == 1 || count <= grain) {
+        run(0, count, user);
+        return;
+    }
+
+    // contiguous runs of chunks per deque keep each thread on neighbouring output
+    size_t chunks = (count + grain - 1) / grain;
+    std::atomic<size_t> pending(chunks);
+    for (int t = 0; t < jobs->threadCount; t++) {
+        size_t first = chunks * t / jobs->threadCount, last = chunks * (t + 1) / jobs->threadCount;
+        JobQueue& queue = jobs->queues[t];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // pushed in reverse so the owner, popping from the back, walks its run forwards
+        for (size_t c = last; c > first; c--) {
+            size_t begin = (c - 1) * grain;
+            queue.jobs.push_back({ run, user, begin, std::min(begin + grain, count), &pending });
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs->sleepMutex);
+        jobs->queued += (int)chunks;
+    }
+    jobs->wake.notify_all();
+
+    while (pending.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if (takeJob(*jobs, 0, job)) runJob(*jobs, job);
+        else std::this_thread::yield();
+    }
+}
+
+JobStats jobStats(const JobSystem& jobs) {
+    JobStats stats;
+    stats.jobs = jobs.jobCount;
+    stats.steals = jobs.stealCount;
+    return stats;
+}
@@ -0,0 +1,60 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+// work-stealing pool for data-parallel CPU work such as tessellation
+// every thread owns a deque of jobs: it takes its own from the back and, when that
+// runs dry, steals from the front of the others, so uneven chunks even out without
+// a central queue; the thread calling parallelFor owns deque 0 and works too
+// the deques are guarded by their own small mutex, contention is only ever a thief
+// parallelFor is meant for one calling thread and must not be called from inside a job
+typedef void (*JobFunction)(size_t begin, size_t end, void* user);
+
+struct Job {
+    JobFunction run;
+    void* user;
+    size_t begin, end;
+    std::atomic<size_t>* pending;
+};
+
+struct JobQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+};
+
+struct JobStats {
+    long long jobs = 0;
+    long long steals = 0;
+};
+
+struct JobSystem {
+    int threadCount = 1; // workers plus the calling thread
+    std::vector<std::thread> workers;
+    std::unique_ptr<JobQueue[]> queues;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{ 0 };
+    bool quit = false;
+
+    std::atomic<long long> jobCount{ 0 }, stealCount{ 0 };
+};
+
+// threads <= 0 uses every hardware thread
+void createJobSystem(JobSystem& jobs, int threads);
+void deleteJobSystem(JobSystem& jobs);
+
+// run(begin, end, user) over [0, count) in chunks of at most grain items, returns once
+// every chunk is done; jobs == NULL or a single thread runs it inline in one call
+void parallelFor(JobSystem* jobs, size_t count, size_t grain, JobFunction run, void* user);
+
+JobStats jobStats(const JobSystem& jobs);
+
+#endif
@@ -0,0 +1,35 @@
+#include "lod.h"
+#include <cmath>
+#include <algorithm>
+
+#define PI 3.14159265358979323846f
+
+float projectedRadius(float radiusX, float radiusY, int viewportWidth, int viewportHeight) {
+    return std::max(std::fabs(radiusX) * viewportWidth, std::fabs(radiusY) * viewportHeight) * 0.5f;
+}
+
+static float chordError(float pixelRadius, int segments) {
+    return pixelRadius * (1.0f - cosf(PI / segments));
+}
+
+int segmentsForRadius(float pixelRadius, const LodSettings& settings) {
+    int segments = settings.minSegments;
+    if (pixelRadius > settings.maxChordError) {
+        float halfAngle = acosf(1.0f - settings.maxChordError / pixelRadius);
+        segments = (int)std::ceil(PI / halfAngle);
+    }
+    return std::min(std::max(segments, settings.minSegments), settings.maxSegments);
+}
+
+int updateSegments(int current, float pixelRadius, const LodSettings& settings) {
+    int wanted = segmentsForRadius(pixelRadius, settings);
+    if (current <= 0 || wanted == current) return wanted;
+
+    // clamped counts do not move with the error, only with the clamp
+    if (wanted == settings.minSegments || wanted == settings.maxSegments) return wanted;
+
+    float error = chordError(pixelRadius, current);
+    float low = settings.maxChordError * (1.0f - settings.hysteresis);
+    float high = settings.maxChordError * (1.0f + settings.hysteresis);
+    return (error >= low && error <= high) ? current : wanted;
+}
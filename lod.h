@@ -0,0 +1,24 @@
+#ifndef LOD_H
+#define LOD_H
+
+// tessellation density from projected size
+// n segments around a radius of r pixels stray from the true curve by at most
+// r * (1 - cos(pi / n)) (the sagitta), so a ring gets the smallest n that keeps
+// this chord error under maxChordError
+struct LodSettings {
+    float maxChordError = 0.5f; // pixels
+    int minSegments = 6;
+    int maxSegments = 1024;
+    float hysteresis = 0.0f;    // 0..1, relative chord error band before an existing ring re-tessellates
+};
+
+// larger semi-axis in pixels for NDC radii on a viewport
+float projectedRadius(float radiusX, float radiusY, int viewportWidth, int viewportHeight);
+
+int segmentsForRadius(float pixelRadius, const LodSettings& settings);
+
+// for animated zoom: keeps current while its chord error stays within
+// maxChordError * (1 -/+ hysteresis), otherwise picks a new count
+int updateSegments(int current, float pixelRadius, const LodSettings& settings);
+
+#endif
@@ -1,42 +1,38 @@
 #include <iostream>
+#include <cstring>
+#include "scenes.h"
 
-// UNCOMMENT!
-//to run one of the tasks
+int runner_main(const Scene* scene);
+int headless_main(int argc, char** argv);
+int benchmark_main(int argc, char** argv);
+int selftest_main();
 
-#define RUN_TRIANGLE
-//#define RUN_SQUARE
-//#define RUN_TASK2_PART1
-//#define RUN_TASK2_PART2
-
-#ifdef RUN_TRIANGLE
-int triangle_main();
-int main() { return triangle_main(); }
-#endif
-
-#ifdef RUN_SQUARE
-int square_main();
-int main() { return square_main(); }
-#endif
-
-#ifdef RUN_TASK2_PART1
-int part1_main();
-int main() { return part1_main(); }
-#endif
+static void printUsage() {
+    std::cout << "usage: opengl [scene] | --headless [--size WxH] | --benchmark [options] | --selftest" << std::endl;
+    std::cout << "Available scenes (keys 1-" << sceneCount << " switch while running):" << std::endl;
+    for (int i = 0; i < sceneCount; i++) {
+        std::cout << "  " << (i + 1) << "  " << sceneRegistry[i]->name << "  - " << sceneRegistry[i]->title << std::endl;
+    }
+    std::cout << "  --headless   - all scenes to .ppm, no window (--size WxH, default 1024x1024)" << std::endl;
+    std::cout << "  --benchmark  - headless stress test of every scene (--benchmark --help for options)" << std::endl;
+    std::cout << "  --selftest   - check the CPU kernels, non-zero exit on failure" << std::endl;
+}
 
-#ifdef RUN_TASK2_PART2
-int part2_main();
-int main() { return part2_main(); }
-#endif
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        return benchmark_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0) {
+        return headless_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && strcmp(argv[1], "--selftest") == 0) {
+        return selftest_main();
+    }
 
-// If no task is selected:
-#if !defined(RUN_TRIANGLE) && !defined(RUN_SQUARE) && !defined(RUN_TASK2_PART1) && !defined(RUN_TASK2_PART2)
-int main() {
-    std::cout << "Please uncomment a task in main.cpp!" << std::endl;
-    std::cout << "Available options:" << std::endl;
-    std::cout << "  #define RUN_TRIANGLE     - red triangle" << std::endl;
-    std::cout << "  #define RUN_SQUARE       - blue square" << std::endl;
-    std::cout << "  #define RUN_TASK2_PART1  - four shapes" << std::endl;
-    std::cout << "  #define RUN_TASK2_PART2  - creative shapes" << std::endl;
-    return 0;
+    const Scene* scene = findScene(argc > 1 ? argv[1] : "triangle");
+    if (scene == NULL) {
+        printUsage();
+        return -1;
+    }
+    return runner_main(scene);
 }
-#endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "mesh_optimizer.h"
+#include <unordered_map>
+#include <cstring>
+#include <algorithm>
+
+#define VERTEX_FLOATS 5
+
+double computeACMR(const unsigned int* indices, size_t count, int cacheSize) {
+    if (count < 3) return 0.0;
+
+    std::vector<unsigned int> fifo(cacheSize, 0xFFFFFFFFu);
+    size_t head = 0, misses = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool hit = false;
+        for (int c = 0; c < cacheSize; c++) {
+            if (fifo[c] == indices[i]) { hit = true; break; }
+        }
+        if (!hit) {
+            fifo[head] = indices[i];
+            head = (head + 1) % cacheSize;
+            misses++;
+        }
+    }
+    return (double)misses / (count / 3);
+}
+
+struct VertexKey {
+    const float* data;
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        // FNV-1a over the raw bytes, identical bits weld
+        const unsigned char* bytes = (const unsigned char*)key.data;
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < VERTEX_FLOATS * sizeof(float); i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+};
+
+struct VertexKeyEqual {
+    bool operator()(const VertexKey& a, const VertexKey& b) const {
+        return memcmp(a.data, b.data, VERTEX_FLOATS * sizeof(float)) == 0;
+    }
+};
+
+// remaps indices to the first copy of every vertex value
+static void weldVertices(const std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash, VertexKeyEqual> firstCopy;
+    firstCopy.reserve(vertexCount);
+
+    std::vector<unsigned int> remap(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        VertexKey key = { &vertices[v * VERTEX_FLOATS] };
+        remap[v] = firstCopy.emplace(key, (unsigned int)v).first->second;
+    }
+    for (unsigned int& index : indices) {
+        index = remap[index];
+    }
+}
+
+static int nextDeadEnd(const std::vector<int>& live, std::vector<unsigned int>& deadEnds, size_t& cursor) {
+    while (!deadEnds.empty()) {
+        unsigned int v = deadEnds.back();
+        deadEnds.pop_back();
+        if (live[v] > 0) return (int)v;
+    }
+    while (cursor < live.size()) {
+        if (live[cursor] > 0) return (int)cursor++;
+        cursor++;
+    }
+    return -1;
+}
+
+// Tipsify: fan around the current vertex, then move to the neighbour that is
+// still in cache and has the fewest live triangles left
+static void tipsify(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize, std::vector<unsigned int>& out) {
+    size_t triangleCount = indices.size() / 3;
+
+    // vertex -> triangles adjacency in CSR form
+    std::vector<int> live(vertexCount, 0);
+    for (unsigned int index : indices) live[index]++;
+    std::vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+    }
+
+    std::vector<int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnds, candidates;
+    int time = cacheSize + 1;
+    size_t cursor = 1;
+
+    out.clear();
+    out.reserve(indices.size());
+
+    int fanning = 0;
+    while (fanning >= 0) {
+        candidates.clear();
+        for (size_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            unsigned int t = adjacency[a];
+            if (emitted[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[t * 3 + k];
+                out.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+            emitted[t] = true;
+        }
+
+        int best = -1, bestPriority = -1;
+        for (unsigned int v : candidates) {
+            if (live[v] <= 0) continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize) priority = time - cacheTime[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = (int)v;
+            }
+        }
+        fanning = (best >= 0) ? best : nextDeadEnd(live, deadEnds, cursor);
+    }
+}
+
+// Tipsify over indices[begin, end) alone, on range-local vertex numbers so the cost
+// follows the range rather than the whole mesh; localIds must be all 0xFFFFFFFF and is left so
+static void reorderRange(std::vector<unsigned int>& indices, size_t begin, size_t end, std::vector<unsigned int>& localIds) {
+    std::vector<unsigned int> local(end - begin), globalIds;
+    for (size_t i = begin; i < end; i++) {
+        unsigned int& id = localIds[indices[i]];
+        if (id == 0xFFFFFFFFu) {
+            id = (unsigned int)globalIds.size();
+            globalIds.push_back(indices[i]);
+        }
+        local[i - begin] = id;
+    }
+    for (unsigned int v : globalIds) localIds[v] = 0xFFFFFFFFu;
+
+    std::vector<unsigned int> reordered;
+    tipsify(local, globalIds.size(), MESH_CACHE_SIZE, reordered);
+    if (computeACMR(reordered.data(), reordered.size(), MESH_CACHE_SIZE) <
+        computeACMR(local.data(), local.size(), MESH_CACHE_SIZE)) {
+        for (size_t i = begin; i < end; i++) indices[i] = globalIds[reordered[i - begin]];
+    }
+}
+
+void optimizeMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices, MeshOptimizeReport* report,
+                  const size_t* rangeEnds, size_t rangeCount) {
+    size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+    if (report) {
+        report->verticesBefore = vertexCount;
+        report->triangles = indices.size() / 3;
+        report->acmrBefore = computeACMR(indices.data(), indices.size(), MESH_CACHE_SIZE);
+    }
+
+    weldVertices(vertices, indices);
+
+    if (vertexCount > 0 && !indices.empty()) {
+        std::vector<unsigned int> localIds(vertexCount, 0xFFFFFFFFu);
+        size_t begin = 0;
+        for (size_t r = 0; r <= rangeCount && begin < indices.size(); r++) {
+            size_t end = (r < rangeCount) ? std::min(rangeEnds[r], indices.size()) : indices.size();
+            end = begin + (end > begin ? (end - begin) / 3 * 3 : 0);
+            if (end - begin >= 6) reorderRange(indices, begin, end, localIds);
+            begin = std::max(begin, end);
+        }
+    }
+
+    // first-use renumbering, unreferenced vertices get no slot
+    std::vector<unsigned int> remap(vertexCount, 0xFFFFFFFFu);
+    std::vector<float> compacted;
+    compacted.reserve(vertices.size());
+    unsigned int next = 0;
+    for (unsigned int& index : indices) {
+        if (remap[index] == 0xFFFFFFFFu) {
+            remap[index] = next++;
+            compacted.insert(compacted.end(), &vertices[index * VERTEX_FLOATS], &vertices[index * VERTEX_FLOATS] + VERTEX_FLOATS);
+        }
+        index = remap[index];
+    }
+    vertices.swap(compacted);
+
+    if (report) {
+        report->verticesAfter = vertices.size() / VERTEX_FLOATS;
+        report->acmrAfter = computeACMR(indices.data(), indices.size(), MESH_CACHE_SIZE);
+    }
+}
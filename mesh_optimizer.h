@@ -0,0 +1,30 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+#include <vector>
+#include <cstddef>
+
+// cleanup pass run on every mesh before upload (uploadBatch, createInstancedMesh)
+// vertices are interleaved [x, y, r, g, b], indices a triangle list
+//  1. weld bit-identical vertices
+//  2. drop vertices no triangle references
+//  3. Tipsify triangle order (Sander et al. 2007), kept only when it lowers ACMR,
+//     so fans from the generators survive for index packing
+//  4. renumber vertices in first-use order for linear vertex fetch
+// with ranges, step 3 reorders triangles only inside each [rangeEnds[i - 1], rangeEnds[i])
+// of the index list: there is no depth test, so shapes must keep their draw order
+#define MESH_CACHE_SIZE 16
+
+// ACMR is cache misses per triangle on a simulated FIFO post-transform cache
+struct MeshOptimizeReport {
+    size_t verticesBefore = 0, verticesAfter = 0;
+    size_t triangles = 0;
+    double acmrBefore = 0.0, acmrAfter = 0.0;
+};
+
+double computeACMR(const unsigned int* indices, size_t count, int cacheSize);
+
+// rangeEnds are ascending index offsets; indices past the last one form a final range
+void optimizeMesh(std::vector<float>& vertices, std::vector<unsigned int>& indices, MeshOptimizeReport* report,
+                  const size_t* rangeEnds = NULL, size_t rangeCount = 0);
+
+#endif
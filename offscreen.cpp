@@ -0,0 +1,116 @@
+#include "offscreen.h"
+#include "arena.h"
+#include "gl_state.h"
+#include "gl_context.h"
+#include <iostream>
+#include <fstream>
+
+GLFWwindow* createHeadlessContext() {
+    // the window is never shown, all rendering goes to an OffscreenTarget
+    return createGLContext(1, 1, "headless", false);
+}
+
+bool createOffscreenTarget(OffscreenTarget& target, int width, int height) {
+    glGenFramebuffers(1, &target.FBO);
+    glGenRenderbuffers(1, &target.colorRBO);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, target.colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorRBO);
+
+    target.width = width;
+    target.height = height;
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "ERROR::FRAMEBUFFER::INCOMPLETE " << width << "x" << height << std::endl;
+        deleteOffscreenTarget(target);
+        return false;
+    }
+
+    cachedViewport(0, 0, width, height);
+    return true;
+}
+
+void deleteOffscreenTarget(OffscreenTarget& target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &target.FBO);
+    glDeleteRenderbuffers(1, &target.colorRBO);
+    target.FBO = target.colorRBO = 0;
+    target.width = target.height = 0;
+}
+
+void readOffscreenPixels(const OffscreenTarget& target, std::vector<unsigned char>& pixels) {
+    pixels.resize((size_t)target.width * target.height * 4);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, target.width, target.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+bool renderSceneOffscreen(const Scene& scene, int width, int height, int frameCount, FrameCallback onFrame, void* user) {
+    OffscreenTarget target;
+    if (!createOffscreenTarget(target, width, height)) return false;
+
+    if (!scene.init()) {
+        deleteOffscreenTarget(target);
+        return false;
+    }
+
+    ReadbackRing ring;
+    if (!createReadbackRing(ring, width, height)) {
+        scene.cleanup();
+        resetArena(sceneArena());
+        deleteOffscreenTarget(target);
+        return false;
+    }
+
+    for (int frame = 0; frame < frameCount; frame++) {
+        glBindFramebuffer(GL_FRAMEBUFFER, target.FBO);
+        scene.draw();
+
+        queueReadback(ring, frame, onFrame, user);
+        pollReadbacks(ring, onFrame, user);
+        resetArena(frameArena());
+    }
+    flushReadbacks(ring, onFrame, user);
+    int delivered = ring.delivered;
+
+    deleteReadbackRing(ring);
+    scene.cleanup();
+    resetArena(sceneArena());
+    deleteOffscreenTarget(target);
+
+    if (delivered < frameCount) {
+        std::cout << "ERROR::OFFSCREEN::FRAMES_LOST " << scene.name << ": " << delivered << " of " << frameCount << " frames read back" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static void copyFrame(int, const unsigned char* rgba, int width, int height, void* user) {
+    std::vector<unsigned char>* pixels = (std::vector<unsigned char>*)user;
+    pixels->assign(rgba, rgba + (size_t)width * height * 4);
+}
+
+bool renderSceneToPixels(const Scene& scene, int width, int height, std::vector<unsigned char>& pixels) {
+    return renderSceneOffscreen(scene, width, height, 1, copyFrame, &pixels);
+}
+
+bool writePPM(const char* path, const unsigned char* rgba, int width, int height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    for (int y = height - 1; y >= 0; y--) {
+        const unsigned char* row = rgba + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++) {
+            file.write((const char*)row + x * 4, 3);
+        }
+    }
+    return (bool)file;
+}
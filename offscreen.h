@@ -0,0 +1,35 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+#include "gl_loader.h"
+#include <GLFW/glfw3.h>
+#include <vector>
+#include "scenes.h"
+#include "readback.h"
+
+// hidden GL 3.3 core context, nothing is shown on screen (see createGLContext)
+GLFWwindow* createHeadlessContext();
+
+// FBO with an RGBA8 colour renderbuffer at any resolution
+struct OffscreenTarget {
+    GLuint FBO = 0, colorRBO = 0;
+    int width = 0, height = 0;
+};
+
+bool createOffscreenTarget(OffscreenTarget& target, int width, int height);
+void deleteOffscreenTarget(OffscreenTarget& target);
+
+// tightly packed RGBA8, bottom row first like glReadPixels
+void readOffscreenPixels(const OffscreenTarget& target, std::vector<unsigned char>& pixels);
+
+// init the scene, render frameCount frames at width x height, hand each frame to onFrame, cleanup
+// readback goes through a PBO ring, so onFrame runs a frame or two behind the draw
+// false unless every one of the frameCount frames reached onFrame
+bool renderSceneOffscreen(const Scene& scene, int width, int height, int frameCount, FrameCallback onFrame, void* user);
+
+// one frame straight into pixels
+bool renderSceneToPixels(const Scene& scene, int width, int height, std::vector<unsigned char>& pixels);
+
+// binary PPM, rows flipped to top-down, alpha dropped
+bool writePPM(const char* path, const unsigned char* rgba, int width, int height);
+
+#endif
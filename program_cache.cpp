@@ -0,0 +1,191 @@
+#include "gl_loader.h"
+#include "program_cache.h"
+#include "gl_state.h"
+#include "shaders.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static std::unordered_map<uint64_t, GLuint> programs;
+static std::string cacheDirectory = "shader_cache";
+
+// FNV-1a, chained over several strings
+static uint64_t hashString(uint64_t hash, const char* text) {
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    }
+    // separator so "ab"+"c" and "a"+"bc" differ
+    hash ^= 0xff;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+static uint64_t programKey(const char* vertexSource, const char* fragmentSource) {
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashString(hash, vertexSource);
+    hash = hashString(hash, fragmentSource);
+
+    // a binary is only valid for the driver that produced it
+    const char* driver[] = {
+        (const char*)glGetString(GL_VENDOR),
+        (const char*)glGetString(GL_RENDERER),
+        (const char*)glGetString(GL_VERSION)
+    };
+    for (const char* text : driver) {
+        hash = hashString(hash, text ? text : "");
+    }
+    return hash;
+}
+
+static bool binarySupported() {
+    if (!hasGLVersion(4, 1) && !hasGLExtension("GL_ARB_get_program_binary")) return false;
+    if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri) return false;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+static std::string binaryPath(uint64_t key) {
+    std::ostringstream path;
+    path << cacheDirectory << "/" << std::hex << key << ".bin";
+    return path.str();
+}
+
+static GLuint loadBinary(uint64_t key) {
+    std::ifstream file(binaryPath(key), std::ios::binary);
+    if (!file) return 0;
+
+    GLenum format = 0;
+    if (!file.read((char*)&format, sizeof(format))) return 0;
+    std::vector<char> blob((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (blob.empty()) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, blob.data(), (GLsizei)blob.size());
+
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // driver update or foreign blob, recompile from source
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void saveBinary(uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> blob(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, blob.data());
+
+#ifdef _WIN32
+    _mkdir(cacheDirectory.c_str());
+#else
+    mkdir(cacheDirectory.c_str(), 0755);
+#endif
+
+    // written under a per-process name and renamed into place, so jobs started together
+    // see either no binary or a whole one, never a file another job is still writing
+    std::string path = binaryPath(key);
+    std::string temporary = path + "." + std::to_string((long long)getpid()) + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "WARNING::PROGRAM_CACHE::CANNOT_WRITE " << temporary << std::endl;
+        return;
+    }
+    file.write((const char*)&format, sizeof(format));
+    file.write(blob.data(), length);
+    file.close();
+    if (!file) {
+        std::cout << "WARNING::PROGRAM_CACHE::CANNOT_WRITE " << temporary << std::endl;
+        std::remove(temporary.c_str());
+        return;
+    }
+
+    // POSIX rename replaces the target atomically; Windows refuses an existing one, which
+    // only means another job saved the same binary first
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+    }
+}
+
+static GLuint linkProgram(const char* vertexSource, const char* fragmentSource, bool retrievable) {
+    GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
+
+    GLuint shaderProgram = glCreateProgram();
+    glAttachShader(shaderProgram, vertexShader);
+    glAttachShader(shaderProgram, fragmentShader);
+    if (retrievable) {
+        glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(shaderProgram);
+
+    int success;
+    char infoLog[512];
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    }
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    return shaderProgram;
+}
+
+GLuint getCachedProgram(const char* vertexSource, const char* fragmentSource) {
+    uint64_t key = programKey(vertexSource, fragmentSource);
+
+    auto found = programs.find(key);
+    if (found != programs.end()) return found->second;
+
+    bool useDisk = !cacheDirectory.empty() && binarySupported();
+
+    GLuint program = useDisk ? loadBinary(key) : 0;
+    if (program == 0) {
+        program = linkProgram(vertexSource, fragmentSource, useDisk);
+
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (success && useDisk) {
+            saveBinary(key, program);
+        }
+    }
+
+    programs[key] = program;
+    return program;
+}
+
+void deleteCachedPrograms() {
+    for (auto& entry : programs) {
+        forgetProgram(entry.second);
+        glDeleteProgram(entry.second);
+    }
+    programs.clear();
+}
+
+void setProgramCacheDirectory(const char* path) {
+    cacheDirectory = path ? path : "";
+}
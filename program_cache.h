@@ -0,0 +1,16 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+#include "gl_loader.h"
+
+// linked programs keyed by a hash of their shader sources and the GL driver
+// reused within the process and saved as glGetProgramBinary blobs in the cache
+// directory (written to a temporary file and renamed, so concurrent runs never read
+// a partial blob); a blob the driver rejects falls back to compiling from source
+// programs are owned by the cache, release them with deleteCachedPrograms()
+GLuint getCachedProgram(const char* vertexSource, const char* fragmentSource);
+void deleteCachedPrograms();
+
+// "shader_cache" by default, an empty string disables the on-disk cache
+void setProgramCacheDirectory(const char* path);
+
+#endif
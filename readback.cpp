@@ -0,0 +1,104 @@
+#include "readback.h"
+#include "gl_state.h"
+#include <iostream>
+
+bool createReadbackRing(ReadbackRing& ring, int width, int height) {
+    ring.width = width;
+    ring.height = height;
+    ring.next = 0;
+    ring.delivered = ring.failed = 0;
+
+    GLsizeiptr size = (GLsizeiptr)width * height * 4;
+
+    glGenBuffers(READBACK_SLOTS, ring.PBOs);
+    for (int i = 0; i < READBACK_SLOTS; i++) {
+        cachedBindBuffer(GL_PIXEL_PACK_BUFFER, ring.PBOs[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        ring.fences[i] = 0;
+        ring.frames[i] = -1;
+    }
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        std::cout << "ERROR::READBACK::CREATE_FAILED " << width << "x" << height << std::endl;
+        deleteReadbackRing(ring);
+        return false;
+    }
+    return true;
+}
+
+void deleteReadbackRing(ReadbackRing& ring) {
+    for (int i = 0; i < READBACK_SLOTS; i++) {
+        if (ring.fences[i]) glDeleteSync(ring.fences[i]);
+        ring.fences[i] = 0;
+        ring.frames[i] = -1;
+    }
+    forgetBuffers(READBACK_SLOTS, ring.PBOs);
+    glDeleteBuffers(READBACK_SLOTS, ring.PBOs);
+}
+
+// maps one slot and hands it to the callback; false if not ready and wait is off
+// a slot that fails to map is freed all the same and counted in ring.failed
+static bool deliver(ReadbackRing& ring, int slot, bool wait, FrameCallback onFrame, void* user) {
+    if (ring.frames[slot] < 0) return false;
+
+    GLenum status = glClientWaitSync(ring.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (wait && status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(ring.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    }
+    if (status == GL_TIMEOUT_EXPIRED) return false;
+    if (status == GL_WAIT_FAILED) {
+        std::cout << "ERROR::READBACK::WAIT_FAILED frame " << ring.frames[slot] << std::endl;
+    }
+
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, ring.PBOs[slot]);
+    GLsizeiptr size = (GLsizeiptr)ring.width * ring.height * 4;
+    const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (pixels) {
+        if (onFrame) onFrame(ring.frames[slot], pixels, ring.width, ring.height, user);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        ring.delivered++;
+    } else {
+        std::cout << "ERROR::READBACK::MAP_FAILED frame " << ring.frames[slot] << std::endl;
+        ring.failed++;
+    }
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glDeleteSync(ring.fences[slot]);
+    ring.fences[slot] = 0;
+    ring.frames[slot] = -1;
+    return true;
+}
+
+void queueReadback(ReadbackRing& ring, int frame, FrameCallback onFrame, void* user) {
+    int slot = ring.next;
+
+    // slots fill round-robin, so an occupied next slot holds the oldest frame
+    if (ring.frames[slot] >= 0) {
+        deliver(ring, slot, true, onFrame, user);
+    }
+
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, ring.PBOs[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, ring.width, ring.height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    cachedBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    ring.fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ring.frames[slot] = frame;
+    ring.next = (slot + 1) % READBACK_SLOTS;
+}
+
+void pollReadbacks(ReadbackRing& ring, FrameCallback onFrame, void* user) {
+    // oldest in-flight slot first, stop at the first one still copying
+    for (int i = 0; i < READBACK_SLOTS; i++) {
+        int slot = (ring.next + i) % READBACK_SLOTS;
+        if (ring.frames[slot] < 0) continue;
+        if (!deliver(ring, slot, false, onFrame, user)) return;
+    }
+}
+
+void flushReadbacks(ReadbackRing& ring, FrameCallback onFrame, void* user) {
+    for (int i = 0; i < READBACK_SLOTS; i++) {
+        deliver(ring, (ring.next + i) % READBACK_SLOTS, true, onFrame, user);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef READBACK_H
+#define READBACK_H
+#include "gl_loader.h"
+
+// receives frames in order; rgba is tightly packed RGBA8, bottom row first,
+// and only valid during the call
+typedef void (*FrameCallback)(int frame, const unsigned char* rgba, int width, int height, void* user);
+
+// ring of pixel-pack buffers so frame N is copied out while frame N+1 renders:
+// glReadPixels into a PBO returns at once, a fence marks when the copy landed,
+// and the frame is mapped and handed to the callback once the fence signals
+#define READBACK_SLOTS 3
+
+struct ReadbackRing {
+    GLuint PBOs[READBACK_SLOTS] = {};
+    GLsync fences[READBACK_SLOTS] = {};
+    int frames[READBACK_SLOTS] = {};
+    int width = 0, height = 0;
+    int next = 0;
+    int delivered = 0; // frames handed to the callback
+    int failed = 0;    // frames lost because their slot could not be mapped
+};
+
+// false (with nothing left to delete) if the buffers could not be allocated
+bool createReadbackRing(ReadbackRing& ring, int width, int height);
+void deleteReadbackRing(ReadbackRing& ring);
+
+// reads the bound GL_READ_FRAMEBUFFER; if every slot is in flight the oldest frame is delivered first
+void queueReadback(ReadbackRing& ring, int frame, FrameCallback onFrame, void* user);
+
+// delivers the frames whose copies have finished, never blocks
+void pollReadbacks(ReadbackRing& ring, FrameCallback onFrame, void* user);
+
+// waits for and delivers every frame still in flight
+void flushReadbacks(ReadbackRing& ring, FrameCallback onFrame, void* user);
+
+#endif
@@ -0,0 +1,86 @@
+#include "gl_context.h"
+#include "gl_state.h"
+#include "scenes.h"
+#include "program_cache.h"
+#include "frame_stats.h"
+#include "frame_pacing.h"
+#include "arena.h"
+#include <iostream>
+
+// scene picked by a key press, switched at the start of the next frame
+static const Scene* requestedScene = NULL;
+
+static void keyCallback(GLFWwindow* window, int key, int, int action, int) {
+    if (action != GLFW_PRESS) return;
+
+    if (key == GLFW_KEY_ESCAPE) {
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+    } else if (key >= GLFW_KEY_1 && key < GLFW_KEY_1 + sceneCount) {
+        requestedScene = sceneRegistry[key - GLFW_KEY_1];
+    }
+}
+
+static void framebufferSizeCallback(GLFWwindow*, int width, int height) {
+    cachedViewport(0, 0, width, height);
+}
+
+// one window, context, loader set and program cache for every scene;
+// keys 1-4 switch scenes without tearing any of it down
+int runner_main(const Scene* scene) {
+    GLFWwindow* window = createGLContext(500, 500, scene->title, true);
+    if (window == NULL) {
+        return -1;
+    }
+
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    cachedViewport(0, 0, width, height);
+
+    if (!scene->init()) {
+        std::cout << "Failed to initialize scene " << scene->name << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+
+    FrameStats stats;
+    initFrameStatsFromEnv(stats);
+    FramePacing pacing;
+    initFramePacingFromEnv(pacing);
+
+    // a scene that fails to initialize on a switch is not cleaned up, and the exit code says so
+    bool sceneReady = true;
+    while (!glfwWindowShouldClose(window)) {
+        if (requestedScene != NULL && requestedScene != scene) {
+            scene->cleanup();
+            resetArena(sceneArena());
+            scene = requestedScene;
+            if (!scene->init()) {
+                std::cout << "Failed to initialize scene " << scene->name << std::endl;
+                sceneReady = false;
+                break;
+            }
+            glfwSetWindowTitle(window, scene->title);
+        }
+        requestedScene = NULL;
+
+        beginFrameStats(stats);
+        scene->draw();
+        endFrameStats(stats);
+        resetArena(frameArena());
+
+        presentFrame(pacing, window);
+    }
+
+    finishFrameStats(stats);
+    finishFramePacing(pacing);
+    if (sceneReady) scene->cleanup();
+    freeArena(frameArena());
+    freeArena(sceneArena());
+    deleteCachedPrograms();
+
+    glfwTerminate();
+    return sceneReady ? 0 : -1;
+}
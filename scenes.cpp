@@ -0,0 +1,12 @@
+#include "scenes.h"
+#include <cstring>
+
+const Scene* const sceneRegistry[] = { &triangleScene, &squareScene, &part1Scene, &part2Scene };
+const int sceneCount = sizeof(sceneRegistry) / sizeof(sceneRegistry[0]);
+
+const Scene* findScene(const char* name) {
+    for (int i = 0; i < sceneCount; i++) {
+        if (strcmp(sceneRegistry[i]->name, name) == 0) return sceneRegistry[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef SCENES_H
+#define SCENES_H
+
+// a task scene split into GL setup, one frame of drawing and teardown, so scenes
+// can be switched inside one context (runner.cpp) or rendered offscreen
+// init expects a current GL 3.3 context with function pointers loaded;
+// shader programs come from the program cache and outlive the scene
+struct Scene {
+    const char* name;
+    const char* title;
+    bool (*init)();
+    void (*draw)();
+    void (*cleanup)();
+};
+
+extern const Scene triangleScene;
+extern const Scene squareScene;
+extern const Scene part1Scene;
+extern const Scene part2Scene;
+
+// every scene in menu order, keys 1..sceneCount in the runner
+extern const Scene* const sceneRegistry[];
+extern const int sceneCount;
+
+// NULL if no scene has that name
+const Scene* findScene(const char* name);
+
+#endif
@@ -0,0 +1,83 @@
+#include "sdf.h"
+#include "gl_state.h"
+#include "frame_stats.h"
+#include <cmath>
+
+#define PI 3.14159265358979323846f
+
+SdfShape sdfEllipse(const RingShape& ring) {
+    return { ring.centerX, ring.centerY, ring.radiusX, ring.radiusY, 0.0f, ring.startAngle, 0.0f,
+             (float)SDF_ELLIPSE, (float)ring.gradient, ring.center, ring.rimFrom, ring.rimTo };
+}
+
+SdfShape sdfPolygon(const RingShape& ring) {
+    // the edge midpoint is the inner corner of a star with straight sides
+    float inner = ring.radiusX * cosf(PI / ring.segments);
+    return { ring.centerX, ring.centerY, ring.radiusX, ring.radiusX, inner, ring.startAngle, (float)ring.segments,
+             (float)SDF_STAR, (float)ring.gradient, ring.center, ring.rimFrom, ring.rimTo };
+}
+
+SdfShape sdfStar(const StarShape& star) {
+    return { star.centerX, star.centerY, star.outerRadius, star.outerRadius, star.innerRadius, star.startAngle,
+             (float)star.points, (float)SDF_STAR, (float)SDF_GRADIENT_EDGE, star.center, star.outer, star.inner };
+}
+
+void createSdfBatch(SdfBatch& batch) {
+    float corners[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+    glGenVertexArrays(1, &batch.VAO);
+    glGenBuffers(1, &batch.quadVBO);
+    glGenBuffers(1, &batch.instanceVBO);
+
+    cachedBindVertexArray(batch.VAO);
+
+    cachedBindBuffer(GL_ARRAY_BUFFER, batch.quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    cachedEnableVertexAttribArray(0);
+
+    cachedBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, centerX));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, radiusX));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, innerRadius));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, gradient));
+    glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, center));
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, rimFrom));
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(SdfShape), (void*)offsetof(SdfShape, rimTo));
+    for (GLuint location = 1; location <= 7; location++) {
+        cachedEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    cachedBindVertexArray(0);
+    batch.count = 0;
+}
+
+void uploadSdfShapes(SdfBatch& batch, const SdfShape* shapes, size_t count) {
+    cachedBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, count * sizeof(SdfShape), shapes, GL_DYNAMIC_DRAW);
+    batch.count = (GLsizei)count;
+}
+
+void drawSdfBatch(const SdfBatch& batch) {
+    cachedEnable(GL_BLEND);
+    cachedBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    beginTimedDraw();
+    cachedBindVertexArray(batch.VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.count);
+    endTimedDraw(4LL * batch.count);
+
+    cachedDisable(GL_BLEND);
+}
+
+void deleteSdfBatch(SdfBatch& batch) {
+    forgetVertexArray(batch.VAO);
+    forgetBuffers(1, &batch.quadVBO);
+    forgetBuffers(1, &batch.instanceVBO);
+    glDeleteVertexArrays(1, &batch.VAO);
+    glDeleteBuffers(1, &batch.quadVBO);
+    glDeleteBuffers(1, &batch.instanceVBO);
+    batch.VAO = batch.quadVBO = batch.instanceVBO = 0;
+    batch.count = 0;
+}
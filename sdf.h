@@ -0,0 +1,51 @@
+#ifndef SDF_H
+#define SDF_H
+#include "gl_loader.h"
+#include <vector>
+#include <cstddef>
+#include "shapes.h"
+
+// round shapes drawn as one instanced quad each; the fragment shader evaluates the
+// signed distance to the outline for fill, gradient and a one-pixel anti-aliased edge
+// (see createSdfShaderProgram), so cost no longer depends on segment count
+enum SdfKind {
+    SDF_ELLIPSE,
+    SDF_STAR     // also regular polygons: a star whose inner corners sit on the edges
+};
+
+// rim colour modes, the first two match RimGradient
+enum SdfGradient {
+    SDF_GRADIENT_LINEAR = GRADIENT_LINEAR,
+    SDF_GRADIENT_SINE = GRADIENT_SINE,
+    SDF_GRADIENT_EDGE    // rimFrom at the star tips -> rimTo at the inner corners
+};
+
+// one instance; all fields are floats so they feed the attributes directly
+struct SdfShape {
+    float centerX, centerY;
+    float radiusX, radiusY;   // ellipse radii, or the outer radius twice
+    float innerRadius;        // stars only
+    float startAngle;         // first tip / corner, and where linear gradients start
+    float points;             // tips or corners
+    float kind;               // SdfKind
+    float gradient;           // SdfGradient
+    Color center, rimFrom, rimTo;
+};
+
+// same look as the tessellated shape
+SdfShape sdfEllipse(const RingShape& ring);
+SdfShape sdfPolygon(const RingShape& ring);
+SdfShape sdfStar(const StarShape& star);
+
+struct SdfBatch {
+    GLuint VAO = 0, quadVBO = 0, instanceVBO = 0;
+    GLsizei count = 0;
+};
+
+void createSdfBatch(SdfBatch& batch);
+void uploadSdfShapes(SdfBatch& batch, const SdfShape* shapes, size_t count);
+// expects the program from createSdfShaderProgram(); blends for the soft edge
+void drawSdfBatch(const SdfBatch& batch);
+void deleteSdfBatch(SdfBatch& batch);
+
+#endif
@@ -0,0 +1,38 @@
+#include "sincos.h"
+#include <iostream>
+
+struct SinCosSweep {
+    const char* name;
+    float start, step;
+    int count;
+};
+
+// checks the CPU-side kernels that have no GL output to compare against; returns non-zero on failure
+int selftest_main() {
+    // power-of-two steps keep every angle exact in float, so only the kernel's error is measured
+    // odd chunking in ringSinCosMaxError runs the scalar tail after every SIMD block
+    const SinCosSweep sweeps[] = {
+        { "wide", -10000.0f, 1.0f / 64.0f, 20000 * 64 },
+        { "near zero", -4.0f, 1.0f / 65536.0f, 8 * 65536 }
+    };
+    const SinCosPath paths[] = { SINCOS_PATH_SCALAR, SINCOS_PATH_SSE2, SINCOS_PATH_AVX2 };
+
+    int failures = 0;
+    for (SinCosPath path : paths) {
+        if (!sinCosPathAvailable(path)) {
+            std::cout << "sincos " << sinCosPathName(path) << ": skipped, not available on this build or CPU" << std::endl;
+            continue;
+        }
+
+        for (const SinCosSweep& sweep : sweeps) {
+            double error = ringSinCosMaxError(path, sweep.start, sweep.step, sweep.count);
+            bool pass = error < SINCOS_MAX_ERROR;
+            std::cout << "sincos " << sinCosPathName(path) << " " << sweep.name << ": max abs error " << error
+                      << (pass ? " ok" : " FAILED") << std::endl;
+            if (!pass) failures++;
+        }
+    }
+
+    std::cout << "selftest: " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
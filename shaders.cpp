@@ -1,4 +1,5 @@
 #include "shaders.h"
+#include "program_cache.h"
 #include <iostream>
 
 const char* vertexShaderSource = R"(
@@ -26,6 +27,127 @@ void main()
 }
 )";
 
+// same vPosition/vColor inputs, placed and tinted per instance
+const char* instancedVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 vPosition;
+layout (location = 1) in vec3 vColor;
+layout (location = 2) in vec2 iCenter;
+layout (location = 3) in vec2 iScale;
+layout (location = 4) in float iRotation;
+layout (location = 5) in vec3 iColor;
+
+out vec3 fragColor;
+
+void main()
+{
+    vec2 p = vPosition * iScale;
+    float c = cos(iRotation);
+    float s = sin(iRotation);
+    gl_Position = vec4(iCenter + vec2(c * p.x - s * p.y, s * p.x + c * p.y), 0.0, 1.0);
+    fragColor = vColor * iColor;
+}
+)";
+
+// one quad per shape, see sdf.h for the instance layout
+const char* sdfVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 vCorner;
+layout (location = 1) in vec2 iCenter;
+layout (location = 2) in vec2 iRadius;
+layout (location = 3) in vec4 iShape; // inner radius, start angle, points, kind
+layout (location = 4) in float iGradient;
+layout (location = 5) in vec3 iCenterColor;
+layout (location = 6) in vec3 iRimFrom;
+layout (location = 7) in vec3 iRimTo;
+
+out vec2 localPos;
+flat out vec2 radius;
+flat out vec4 shape;
+flat out float gradient;
+flat out vec3 centerColor;
+flat out vec3 rimFrom;
+flat out vec3 rimTo;
+
+void main()
+{
+    // margin so the anti-aliased edge is not cut off by the quad
+    localPos = vCorner * (iRadius * 1.05 + 0.005);
+    gl_Position = vec4(iCenter + localPos, 0.0, 1.0);
+
+    radius = iRadius;
+    shape = iShape;
+    gradient = iGradient;
+    centerColor = iCenterColor;
+    rimFrom = iRimFrom;
+    rimTo = iRimTo;
+}
+)";
+
+// colours follow the tessellated fans: centre -> rim along the ray from the centre
+const char* sdfFragmentShaderSource = R"(
+#version 330 core
+#define PI 3.14159265358979
+
+in vec2 localPos;
+flat in vec2 radius;
+flat in vec4 shape;
+flat in float gradient;
+flat in vec3 centerColor;
+flat in vec3 rimFrom;
+flat in vec3 rimTo;
+
+out vec4 FragColor;
+
+void main()
+{
+    float d, radial, along = 0.0, angle;
+
+    if (shape.w < 0.5) {
+        // ellipse, approximate distance (exact for circles)
+        vec2 q = localPos / radius;
+        float k0 = length(q);
+        float k1 = length(q / radius);
+        d = k0 * (k0 - 1.0) / max(k1, 1e-6);
+        radial = k0;
+        angle = atan(q.y, q.x);
+    } else {
+        // star: fold into the wedge between a tip (angle 0) and the next inner corner
+        float c = cos(shape.y), s = sin(shape.y);
+        vec2 p = vec2(c * localPos.x + s * localPos.y, c * localPos.y - s * localPos.x);
+        float an = PI / shape.z;
+        float theta = atan(p.y, p.x);
+        float a = abs(mod(theta + an, 2.0 * an) - an);
+        vec2 u = vec2(cos(a), sin(a));
+        vec2 q = length(p) * u;
+
+        vec2 tip = vec2(radius.x, 0.0);
+        vec2 e = shape.x * vec2(cos(an), sin(an)) - tip;
+        vec2 w = q - tip;
+        float h = clamp(dot(w, e) / dot(e, e), 0.0, 1.0);
+        float dist = length(w - e * h);
+        d = (e.x * w.y - e.y * w.x > 0.0) ? -dist : dist;
+
+        // where the ray through q leaves the shape
+        float t = (tip.x * e.y - tip.y * e.x) / (u.x * e.y - u.y * e.x);
+        radial = length(q) / t;
+        along = clamp(dot(t * u - tip, e) / dot(e, e), 0.0, 1.0);
+        angle = theta + shape.y;
+    }
+
+    float rimT;
+    if (gradient < 0.5) rimT = fract((angle - shape.y) / (2.0 * PI));
+    else if (gradient < 1.5) rimT = 0.5 + 0.5 * sin(angle);
+    else rimT = along;
+
+    vec3 rim = mix(rimFrom, rimTo, rimT);
+    float alpha = clamp(0.5 - d / fwidth(d), 0.0, 1.0);
+    if (alpha <= 0.0) discard;
+
+    FragColor = vec4(mix(centerColor, rim, clamp(radial, 0.0, 1.0)), alpha);
+}
+)";
+
 GLuint compileShader(const char* source, GLenum type) {
     GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, NULL);
@@ -43,24 +165,13 @@ GLuint compileShader(const char* source, GLenum type) {
 }
 
 GLuint createShaderProgram() {
-    GLuint vertexShader = compileShader(vertexShaderSource, GL_VERTEX_SHADER);
-    GLuint fragmentShader = compileShader(fragmentShaderSource, GL_FRAGMENT_SHADER);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    int success;
-    char infoLog[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
+    return getCachedProgram(vertexShaderSource, fragmentShaderSource);
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+GLuint createInstancedShaderProgram() {
+    return getCachedProgram(instancedVertexShaderSource, fragmentShaderSource);
+}
 
-    return shaderProgram;
+GLuint createSdfShaderProgram() {
+    return getCachedProgram(sdfVertexShaderSource, sdfFragmentShaderSource);
 }
@@ -1,8 +1,11 @@
 #ifndef SHADERS_H
 #define SHADERS_H
-#include <GL/glew.h>
+#include "gl_loader.h"
 
 GLuint compileShader(const char* source, GLenum type);
+// shared through the program cache, released by deleteCachedPrograms()
 GLuint createShaderProgram();
+GLuint createInstancedShaderProgram();
+GLuint createSdfShaderProgram();
 
 #endif
@@ -0,0 +1,241 @@
+#include "shape_list.h"
+#include "gl_state.h"
+#include "frame_stats.h"
+#include "mesh_optimizer.h"
+#include <algorithm>
+
+// shapes per job: enough work per chunk to hide the queue traffic
+#define TESSELLATE_GRAIN 256
+
+static int addRetained(ShapeList& list, const RetainedShape& shape) {
+    list.shapes.push_back(shape);
+    list.layoutDirty = true;
+    return (int)list.shapes.size() - 1;
+}
+
+int addShape(ShapeList& list, const RingShape& shape) {
+    RetainedShape retained = {};
+    retained.kind = SHAPE_RING;
+    retained.ring = shape;
+    return addRetained(list, retained);
+}
+
+int addShape(ShapeList& list, const StarShape& shape) {
+    RetainedShape retained = {};
+    retained.kind = SHAPE_STAR;
+    retained.star = shape;
+    return addRetained(list, retained);
+}
+
+int addShape(ShapeList& list, const FlowerShape& shape) {
+    RetainedShape retained = {};
+    retained.kind = SHAPE_FLOWER;
+    retained.flower = shape;
+    return addRetained(list, retained);
+}
+
+int addShape(ShapeList& list, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    RetainedShape retained = {};
+    retained.kind = SHAPE_MESH;
+    retained.meshVertices.assign(vertices, vertices + vertexCount * 5);
+    retained.meshIndices.assign(indices, indices + indexCount);
+    optimizeMesh(retained.meshVertices, retained.meshIndices, NULL);
+    return addRetained(list, retained);
+}
+
+RetainedShape& editShape(ShapeList& list, int id) {
+    RetainedShape& shape = list.shapes[id];
+    if (!shape.dirty) {
+        shape.dirty = true;
+        list.dirtyShapes.push_back(id);
+    }
+    return shape;
+}
+
+void moveShape(ShapeList& list, int id, float dx, float dy) {
+    RetainedShape& shape = editShape(list, id);
+    switch (shape.kind) {
+    case SHAPE_RING: shape.ring.centerX += dx; shape.ring.centerY += dy; break;
+    case SHAPE_STAR: shape.star.centerX += dx; shape.star.centerY += dy; break;
+    case SHAPE_FLOWER: shape.flower.centerX += dx; shape.flower.centerY += dy; break;
+    case SHAPE_MESH:
+        for (size_t i = 0; i < shape.meshVertices.size(); i += 5) {
+            shape.meshVertices[i] += dx;
+            shape.meshVertices[i + 1] += dy;
+        }
+        break;
+    }
+}
+
+static MeshSize shapeSize(const RetainedShape& shape) {
+    switch (shape.kind) {
+    case SHAPE_RING: return ringSize(shape.ring);
+    case SHAPE_STAR: return starSize(shape.star);
+    case SHAPE_FLOWER: return flowerSize(shape.flower);
+    default: return { (int)(shape.meshVertices.size() / 5), (int)shape.meshIndices.size() };
+    }
+}
+
+static void writeShape(const RetainedShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex) {
+    switch (shape.kind) {
+    case SHAPE_RING: writeRing(shape.ring, vertices, indices, baseVertex); break;
+    case SHAPE_STAR: writeStar(shape.star, vertices, indices, baseVertex); break;
+    case SHAPE_FLOWER: writeFlower(shape.flower, vertices, indices, baseVertex); break;
+    case SHAPE_MESH:
+        std::copy(shape.meshVertices.begin(), shape.meshVertices.end(), vertices);
+        for (size_t i = 0; i < shape.meshIndices.size(); i++) {
+            indices[i] = baseVertex + shape.meshIndices[i];
+        }
+        break;
+    }
+}
+
+struct TessellateJob {
+    ShapeList* list;
+    unsigned int* indices;
+};
+
+static void tessellateShapes(size_t begin, size_t end, void* user) {
+    TessellateJob* job = (TessellateJob*)user;
+    for (size_t i = begin; i < end; i++) {
+        RetainedShape& shape = job->list->shapes[i];
+        writeShape(shape, job->list->vertices.data() + shape.firstVertex * 5, job->indices + shape.firstIndex, (unsigned int)shape.firstVertex);
+        shape.dirty = false;
+    }
+}
+
+unsigned int* tessellateShapeList(ShapeList& list, Arena& arena, size_t& indexCount) {
+    size_t vertexCount = 0;
+    indexCount = 0;
+    for (RetainedShape& shape : list.shapes) {
+        shape.size = shapeSize(shape);
+        shape.firstVertex = vertexCount;
+        shape.firstIndex = indexCount;
+        vertexCount += shape.size.vertices;
+        indexCount += shape.size.indices;
+    }
+
+    unsigned int* indices = arenaArray<unsigned int>(arena, indexCount);
+    list.vertices.resize(vertexCount * 5);
+    TessellateJob job = { &list, indices };
+    parallelFor(list.jobs, list.shapes.size(), TESSELLATE_GRAIN, tessellateShapes, &job);
+    list.dirtyShapes.clear();
+    return indices;
+}
+
+static void uploadLayout(ShapeList& list) {
+    if (list.VAO == 0) {
+        glGenVertexArrays(1, &list.VAO);
+        glGenBuffers(1, &list.VBO);
+        glGenBuffers(1, &list.EBO);
+    }
+
+    Arena& arena = frameArena();
+    size_t indexCount;
+    unsigned int* indices = tessellateShapeList(list, arena, indexCount);
+    size_t vertexCount = list.vertices.size() / 5;
+    size_t vertexBytes = vertexCount * list.vertexFormat->stride;
+
+    unsigned char* encoded = arenaArray<unsigned char>(arena, vertexBytes);
+    encodeVertices(*list.vertexFormat, list.vertices.data(), vertexCount, encoded);
+    PackedIndices packed;
+    packIndices(indices, indexCount, arena, packed);
+
+    cachedBindVertexArray(list.VAO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, list.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, encoded, GL_DYNAMIC_DRAW);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, list.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, packed.bytes, packed.data, GL_STATIC_DRAW);
+    applyVertexFormat(*list.vertexFormat);
+    cachedBindVertexArray(0);
+
+    list.indexFormat = packed.format;
+    list.indexCount = packed.count;
+    list.vertexBytes = vertexBytes;
+    list.indexBytes = packed.bytes;
+    list.layoutDirty = false;
+    list.stats.layoutUploads++;
+    list.stats.uploadedBytes += vertexBytes + packed.bytes;
+}
+
+struct DirtyRange {
+    size_t first, count; // vertices
+};
+
+void flushShapeList(ShapeList& list) {
+    if (!list.layoutDirty) {
+        for (int id : list.dirtyShapes) {
+            MeshSize size = shapeSize(list.shapes[id]);
+            if (size.vertices != list.shapes[id].size.vertices || size.indices != list.shapes[id].size.indices) {
+                list.layoutDirty = true;
+                break;
+            }
+        }
+    }
+    if (list.layoutDirty) {
+        uploadLayout(list);
+        return;
+    }
+    if (list.dirtyShapes.empty()) return;
+
+    // re-tessellate in place; the indices come out identical and go to scratch
+    Arena& arena = frameArena();
+    size_t rangeCount = list.dirtyShapes.size();
+    DirtyRange* ranges = arenaArray<DirtyRange>(arena, rangeCount);
+    unsigned int* scratch = NULL;
+    size_t scratchSize = 0;
+    for (size_t i = 0; i < rangeCount; i++) {
+        RetainedShape& shape = list.shapes[list.dirtyShapes[i]];
+        if ((size_t)shape.size.indices > scratchSize) {
+            scratchSize = shape.size.indices;
+            scratch = arenaArray<unsigned int>(arena, scratchSize);
+        }
+        writeShape(shape, list.vertices.data() + shape.firstVertex * 5, scratch, (unsigned int)shape.firstVertex);
+        shape.dirty = false;
+        ranges[i] = { shape.firstVertex, (size_t)shape.size.vertices };
+    }
+    list.dirtyShapes.clear();
+
+    std::sort(ranges, ranges + rangeCount, [](const DirtyRange& a, const DirtyRange& b) { return a.first < b.first; });
+
+    size_t stride = list.vertexFormat->stride;
+    size_t mergeGap = SHAPE_LIST_MERGE_GAP / stride;
+    cachedBindBuffer(GL_ARRAY_BUFFER, list.VBO);
+
+    size_t r = 0;
+    while (r < rangeCount) {
+        size_t first = ranges[r].first, end = first + ranges[r].count;
+        for (r++; r < rangeCount && ranges[r].first <= end + mergeGap; r++) {
+            end = std::max(end, ranges[r].first + ranges[r].count);
+        }
+
+        size_t bytes = (end - first) * stride;
+        unsigned char* encoded = arenaArray<unsigned char>(arena, bytes);
+        encodeVertices(*list.vertexFormat, list.vertices.data() + first * 5, end - first, encoded);
+        glBufferSubData(GL_ARRAY_BUFFER, first * stride, bytes, encoded);
+        list.stats.rangeUploads++;
+        list.stats.uploadedBytes += bytes;
+    }
+}
+
+void drawShapeList(const ShapeList& list) {
+    beginTimedDraw();
+    cachedBindVertexArray(list.VAO);
+    drawIndexed(list.indexFormat, list.indexCount, 1);
+    endTimedDraw((long long)(list.vertices.size() / 5));
+}
+
+void deleteShapeList(ShapeList& list) {
+    forgetVertexArray(list.VAO);
+    forgetBuffers(1, &list.VBO);
+    forgetBuffers(1, &list.EBO);
+    glDeleteVertexArrays(1, &list.VAO);
+    glDeleteBuffers(1, &list.VBO);
+    glDeleteBuffers(1, &list.EBO);
+    list.VAO = list.VBO = list.EBO = 0;
+    list.indexCount = 0;
+    list.shapes.clear();
+    list.vertices.clear();
+    list.dirtyShapes.clear();
+    list.layoutDirty = true;
+}
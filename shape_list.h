@@ -0,0 +1,91 @@
+#ifndef SHAPE_LIST_H
+#define SHAPE_LIST_H
+#include "gl_loader.h"
+#include <vector>
+#include <cstddef>
+#include "shapes.h"
+#include "baked_shapes.h"
+#include "index_buffer.h"
+#include "vertex_format.h"
+#include "job_system.h"
+
+// retained shapes sharing one GL_DYNAMIC_DRAW vertex buffer, each owning a fixed vertex range
+// editing a shape re-tessellates only that shape and marks its range dirty; flushShapeList()
+// merges dirty ranges closer than SHAPE_LIST_MERGE_GAP and sends each with glBufferSubData
+// a shape whose vertex or index count changes (e.g. a new segment count) moves every range
+// after it, so that flush rebuilds the layout and re-uploads both buffers once
+// indices depend only on the layout and are written on layout changes only
+// the mesh optimizer runs per shape, inside its own range: fixed meshes are optimized once in
+// addShape and their range sized from the result; the ring/star/flower generators emit no
+// duplicate or unreferenced vertices, so re-tessellated shapes need no pass
+#define SHAPE_LIST_MERGE_GAP 1024 // clean bytes worth re-sending to save one call
+
+enum ShapeKind {
+    SHAPE_RING,
+    SHAPE_STAR,
+    SHAPE_FLOWER,
+    SHAPE_MESH // fixed [x, y, r, g, b] vertices and local triangle indices
+};
+
+struct RetainedShape {
+    ShapeKind kind;
+    RingShape ring;
+    StarShape star;
+    FlowerShape flower;
+    std::vector<float> meshVertices;
+    std::vector<unsigned int> meshIndices;
+
+    size_t firstVertex = 0, firstIndex = 0;
+    MeshSize size = { 0, 0 }; // as last laid out
+    bool dirty = false;
+};
+
+struct ShapeListStats {
+    long long layoutUploads = 0; // full glBufferData of both buffers
+    long long rangeUploads = 0;  // glBufferSubData calls
+    long long uploadedBytes = 0;
+};
+
+struct ShapeList {
+    std::vector<RetainedShape> shapes;
+    std::vector<float> vertices;   // every shape in list order, [x, y, r, g, b]
+    std::vector<int> dirtyShapes;  // edited since the last flush
+    bool layoutDirty = true;
+    const VertexFormat* vertexFormat = &floatVertexFormat;
+    JobSystem* jobs = NULL; // tessellates layouts in parallel when set
+
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    IndexFormat indexFormat;
+    GLsizei indexCount = 0;
+    size_t vertexBytes = 0, indexBytes = 0;
+    ShapeListStats stats;
+};
+
+// each returns the shape's id, stable for the life of the list
+int addShape(ShapeList& list, const RingShape& shape);
+int addShape(ShapeList& list, const StarShape& shape);
+int addShape(ShapeList& list, const FlowerShape& shape);
+int addShape(ShapeList& list, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+
+// compile-time mesh from baked_shapes.h, copied in as a fixed mesh
+template <int V, int I>
+int addShape(ShapeList& list, const BakedMesh<V, I>& mesh) {
+    return addShape(list, mesh.vertices, V, mesh.indices, I);
+}
+
+// marks the shape dirty and returns it for changes; valid until the next addShape
+RetainedShape& editShape(ShapeList& list, int id);
+void moveShape(ShapeList& list, int id, float dx, float dy);
+
+// lays every shape out back to back and tessellates it into vertices and a triangle
+// list; the slices are sized up front, so with jobs each chunk of shapes writes its own
+// slice of both arrays in parallel, with no locks and nothing to merge
+// the triangle list comes from arena; returns it and sets indexCount
+unsigned int* tessellateShapeList(ShapeList& list, Arena& arena, size_t& indexCount);
+
+// sends pending edits to the GPU, once per frame before drawing
+void flushShapeList(ShapeList& list);
+void drawShapeList(const ShapeList& list);
+void deleteShapeList(ShapeList& list);
+
+#endif
@@ -0,0 +1,114 @@
+#include "shapes.h"
+#include "sincos.h"
+#include <cmath>
+
+#define PI 3.14159265358979323846f
+
+// rim angles are evaluated in chunks so sin/cos stay vectorized without heap scratch
+#define SINCOS_CHUNK 64
+
+static inline float* writeVertex(float* out, float x, float y, Color c) {
+    out[0] = x;
+    out[1] = y;
+    out[2] = c.r;
+    out[3] = c.g;
+    out[4] = c.b;
+    return out + 5;
+}
+
+static inline Color mix(Color a, Color b, float t) {
+    return { a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t };
+}
+
+// {0, i, i + 1} fan over rimCount rim vertices, closing back on the first one
+static void writeFanIndices(unsigned int* indices, int rimCount, unsigned int baseVertex) {
+    for (int i = 1; i <= rimCount; i++) {
+        *indices++ = baseVertex;
+        *indices++ = baseVertex + i;
+        *indices++ = baseVertex + i % rimCount + 1;
+    }
+}
+
+// the fan closes on the first rim vertex, so no vertex repeats it at the end
+MeshSize ringSize(const RingShape& shape) {
+    return { shape.segments + 1, shape.segments * 3 };
+}
+
+MeshSize starSize(const StarShape& shape) {
+    return { shape.points * 2 + 1, shape.points * 2 * 3 };
+}
+
+MeshSize flowerSize(const FlowerShape& shape) {
+    return { shape.petals * 3, shape.petals * 3 };
+}
+
+void writeRing(const RingShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex) {
+    vertices = writeVertex(vertices, shape.centerX, shape.centerY, shape.center);
+
+    float step = 2.0f * PI / shape.segments;
+    float sines[SINCOS_CHUNK], cosines[SINCOS_CHUNK];
+
+    for (int first = 0; first < shape.segments; first += SINCOS_CHUNK) {
+        int count = shape.segments - first;
+        if (count > SINCOS_CHUNK) count = SINCOS_CHUNK;
+        ringSinCos(shape.startAngle + first * step, step, count, sines, cosines);
+
+        for (int k = 0; k < count; k++) {
+            float s = sines[k], c = cosines[k];
+            float t = (shape.gradient == GRADIENT_SINE) ? 0.5f + 0.5f * s : (float)(first + k) / shape.segments;
+            vertices = writeVertex(vertices, shape.centerX + shape.radiusX * c, shape.centerY + shape.radiusY * s,
+                                   mix(shape.rimFrom, shape.rimTo, t));
+        }
+    }
+
+    writeFanIndices(indices, shape.segments, baseVertex);
+}
+
+void writeStar(const StarShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex) {
+    vertices = writeVertex(vertices, shape.centerX, shape.centerY, shape.center);
+
+    int corners = shape.points * 2;
+    float step = PI / shape.points;
+    float sines[SINCOS_CHUNK], cosines[SINCOS_CHUNK];
+
+    for (int first = 0; first < corners; first += SINCOS_CHUNK) {
+        int count = corners - first;
+        if (count > SINCOS_CHUNK) count = SINCOS_CHUNK;
+        ringSinCos(shape.startAngle + first * step, step, count, sines, cosines);
+
+        for (int k = 0; k < count; k++) {
+            bool outer = ((first + k) % 2 == 0);
+            float radius = outer ? shape.outerRadius : shape.innerRadius;
+            vertices = writeVertex(vertices, shape.centerX + radius * cosines[k], shape.centerY + radius * sines[k],
+                                   outer ? shape.outer : shape.inner);
+        }
+    }
+
+    writeFanIndices(indices, corners, baseVertex);
+}
+
+void writeFlower(const FlowerShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex) {
+    for (int petal = 0; petal < shape.petals; petal++) {
+        float petalAngle = petal * 2.0f * PI / shape.petals;
+
+        Color color = {
+            0.5f + 0.5f * sinf(petalAngle),
+            0.5f + 0.5f * sinf(petalAngle + 2.0f * PI / 3),
+            0.5f + 0.5f * sinf(petalAngle + 4.0f * PI / 3)
+        };
+        Color centerColor = { color.r * shape.centerShade, color.g * shape.centerShade, color.b * shape.centerShade };
+
+        float sideAngle = petalAngle + PI / shape.petals;
+
+        vertices = writeVertex(vertices, shape.centerX, shape.centerY, centerColor);
+        vertices = writeVertex(vertices, shape.centerX + shape.petalLength * cosf(petalAngle),
+                               shape.centerY + shape.petalLength * sinf(petalAngle), color);
+        vertices = writeVertex(vertices, shape.centerX + shape.petalWidth * cosf(sideAngle),
+                               shape.centerY + shape.petalWidth * sinf(sideAngle), color);
+
+        unsigned int first = baseVertex + petal * 3;
+        *indices++ = first;
+        *indices++ = first + 1;
+        *indices++ = first + 2;
+    }
+}
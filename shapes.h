@@ -0,0 +1,71 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+// parametric tessellation of the task 2 primitives
+// every generator writes interleaved [x, y, r, g, b] vertices and triangle
+// indices into caller-provided memory sized exactly by the matching *Size()
+
+struct Color {
+    float r, g, b;
+};
+
+struct MeshSize {
+    int vertices;
+    int indices;
+};
+
+enum RimGradient {
+    GRADIENT_LINEAR, // rim colour goes rimFrom -> rimTo around the ring
+    GRADIENT_SINE    // rim colour is rimFrom + (rimTo - rimFrom) * (0.5 + 0.5 * sin(angle))
+};
+
+// ellipse, circle and regular polygon: centre vertex plus a fan of segments rim vertices
+struct RingShape {
+    float centerX, centerY;
+    float radiusX, radiusY;
+    float startAngle;
+    int segments;
+    Color center;
+    Color rimFrom, rimTo;
+    RimGradient gradient;
+};
+
+struct StarShape {
+    float centerX, centerY;
+    float outerRadius, innerRadius;
+    float startAngle;
+    int points;
+    Color center, outer, inner;
+};
+
+// rainbow petals, one triangle each, centre vertex darkened by centerShade
+struct FlowerShape {
+    float centerX, centerY;
+    float petalLength, petalWidth;
+    int petals;
+    float centerShade;
+};
+
+// constexpr so fixed shapes can be baked at compile time (baked_shapes.h)
+constexpr RingShape makeEllipse(float centerX, float centerY, float radiusX, float radiusY, int segments, Color color) {
+    return { centerX, centerY, radiusX, radiusY, 0.0f, segments, color, color, color, GRADIENT_LINEAR };
+}
+
+constexpr RingShape makeCircle(float centerX, float centerY, float radius, int segments, Color center, Color rimFrom, Color rimTo) {
+    return { centerX, centerY, radius, radius, 0.0f, segments, center, rimFrom, rimTo, GRADIENT_SINE };
+}
+
+constexpr RingShape makeRegularPolygon(float centerX, float centerY, float radius, int sides, Color center, Color rimFrom, Color rimTo) {
+    return { centerX, centerY, radius, radius, 0.0f, sides, center, rimFrom, rimTo, GRADIENT_LINEAR };
+}
+
+MeshSize ringSize(const RingShape& shape);
+MeshSize starSize(const StarShape& shape);
+MeshSize flowerSize(const FlowerShape& shape);
+
+// indices are offset by baseVertex so shapes can be written straight into a shared buffer
+void writeRing(const RingShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex);
+void writeStar(const StarShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex);
+void writeFlower(const FlowerShape& shape, float* vertices, unsigned int* indices, unsigned int baseVertex);
+
+#endif
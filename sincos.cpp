@@ -0,0 +1,228 @@
+#include "sincos.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SINCOS_SSE2
+#endif
+
+// the AVX2 kernel is built whenever the compiler can emit it, so the self-test can reach it
+// on a CPU that has it; ringSinCos only picks it when the whole build targets AVX2
+#if defined(__AVX2__)
+#define SINCOS_AVX2
+#define SINCOS_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SINCOS_AVX2
+#define SINCOS_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SINCOS_AVX2
+#define SINCOS_AVX2_TARGET
+#endif
+
+#if defined(SINCOS_AVX2)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// angle = j * pi/2 + r with |r| <= pi/4, pi/2 split in three parts so r stays exact
+static const float TWO_OVER_PI = 0.636619772367581343f;
+static const float PIO2_1 = 1.5703125f;
+static const float PIO2_2 = 4.837512969970703125e-4f;
+static const float PIO2_3 = 7.54978995489188216e-8f;
+
+// minimax polynomials on [-pi/4, pi/4]
+static const float S1 = -1.6666654611e-1f, S2 = 8.3321608736e-3f, S3 = -1.9515295891e-4f;
+static const float C1 = 4.166664568298827e-2f, C2 = -1.388731625493765e-3f, C3 = 2.443315711809948e-5f;
+
+static inline void sinCosScalar(float x, float* s, float* c) {
+    float j = std::nearbyint(x * TWO_OVER_PI);
+    int q = (int)j & 3;
+    float r = ((x - j * PIO2_1) - j * PIO2_2) - j * PIO2_3;
+    float r2 = r * r;
+
+    float ps = r + r * r2 * (S1 + r2 * (S2 + r2 * S3));
+    float pc = 1.0f - 0.5f * r2 + r2 * r2 * (C1 + r2 * (C2 + r2 * C3));
+
+    // rotate the result by the quadrant
+    float sv = (q & 1) ? pc : ps;
+    float cv = (q & 1) ? ps : pc;
+    *s = (q & 2) ? -sv : sv;
+    *c = ((q + 1) & 2) ? -cv : cv;
+}
+
+#if defined(SINCOS_AVX2)
+SINCOS_AVX2_TARGET static inline void sinCos8(__m256 x, __m256* s, __m256* c) {
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256i q = _mm256_cvtps_epi32(j);
+
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_1)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_2)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(j, _mm256_set1_ps(PIO2_3)));
+    __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 ps = _mm256_add_ps(_mm256_set1_ps(S2), _mm256_mul_ps(r2, _mm256_set1_ps(S3)));
+    ps = _mm256_add_ps(_mm256_set1_ps(S1), _mm256_mul_ps(r2, ps));
+    ps = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), ps));
+
+    __m256 pc = _mm256_add_ps(_mm256_set1_ps(C2), _mm256_mul_ps(r2, _mm256_set1_ps(C3)));
+    pc = _mm256_add_ps(_mm256_set1_ps(C1), _mm256_mul_ps(r2, pc));
+    pc = _mm256_mul_ps(_mm256_mul_ps(r2, r2), pc);
+    pc = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), pc);
+
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+    __m256 sv = _mm256_blendv_ps(ps, pc, swap);
+    __m256 cv = _mm256_blendv_ps(pc, ps, swap);
+
+    __m256 signS = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    __m256 signC = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+    *s = _mm256_xor_ps(sv, signS);
+    *c = _mm256_xor_ps(cv, signC);
+}
+
+// returns how many leading angles it wrote, the rest is left to the scalar tail
+SINCOS_AVX2_TARGET static int ringSinCosAVX2(float startAngle, float step, int count, float* sines, float* cosines) {
+    int i = 0;
+    __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 index = _mm256_add_ps(_mm256_set1_ps((float)i), lane);
+        __m256 angle = _mm256_add_ps(_mm256_set1_ps(startAngle), _mm256_mul_ps(index, _mm256_set1_ps(step)));
+        __m256 s, c;
+        sinCos8(angle, &s, &c);
+        _mm256_storeu_ps(sines + i, s);
+        _mm256_storeu_ps(cosines + i, c);
+    }
+    return i;
+}
+
+static bool cpuHasAVX2() {
+#if defined(__AVX2__)
+    return true;
+#elif defined(_MSC_VER)
+    // AVX2 in cpuid leaf 7, and the OS saving the YMM registers (OSXSAVE + XCR0)
+    int info[4];
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(SINCOS_SSE2)
+static inline void sinCos4(__m128 x, __m128* s, __m128* c) {
+    // cvtps rounds to nearest under the default MXCSR mode
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+    __m128 j = _mm_cvtepi32_ps(q);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(PIO2_1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PIO2_2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(PIO2_3)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_set1_ps(S2), _mm_mul_ps(r2, _mm_set1_ps(S3)));
+    ps = _mm_add_ps(_mm_set1_ps(S1), _mm_mul_ps(r2, ps));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+
+    __m128 pc = _mm_add_ps(_mm_set1_ps(C2), _mm_mul_ps(r2, _mm_set1_ps(C3)));
+    pc = _mm_add_ps(_mm_set1_ps(C1), _mm_mul_ps(r2, pc));
+    pc = _mm_mul_ps(_mm_mul_ps(r2, r2), pc);
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), pc);
+
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 sv = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    __m128 cv = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+
+    __m128 signS = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 signC = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+    *s = _mm_xor_ps(sv, signS);
+    *c = _mm_xor_ps(cv, signC);
+}
+
+static int ringSinCosSSE2(float startAngle, float step, int count, float* sines, float* cosines) {
+    int i = 0;
+    __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 index = _mm_add_ps(_mm_set1_ps((float)i), lane);
+        __m128 angle = _mm_add_ps(_mm_set1_ps(startAngle), _mm_mul_ps(index, _mm_set1_ps(step)));
+        __m128 s, c;
+        sinCos4(angle, &s, &c);
+        _mm_storeu_ps(sines + i, s);
+        _mm_storeu_ps(cosines + i, c);
+    }
+    return i;
+}
+#endif
+
+const char* sinCosPathName(SinCosPath path) {
+    switch (path) {
+    case SINCOS_PATH_AVX2: return "avx2";
+    case SINCOS_PATH_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+SinCosPath defaultSinCosPath() {
+#if defined(__AVX2__)
+    return SINCOS_PATH_AVX2;
+#elif defined(SINCOS_SSE2)
+    return SINCOS_PATH_SSE2;
+#else
+    return SINCOS_PATH_SCALAR;
+#endif
+}
+
+bool sinCosPathAvailable(SinCosPath path) {
+    switch (path) {
+#if defined(SINCOS_AVX2)
+    case SINCOS_PATH_AVX2: return cpuHasAVX2();
+#endif
+#if defined(SINCOS_SSE2)
+    case SINCOS_PATH_SSE2: return true;
+#endif
+    case SINCOS_PATH_SCALAR: return true;
+    default: return false;
+    }
+}
+
+void ringSinCosPath(SinCosPath path, float startAngle, float step, int count, float* sines, float* cosines) {
+    int i = 0;
+
+#if defined(SINCOS_AVX2)
+    if (path == SINCOS_PATH_AVX2) i = ringSinCosAVX2(startAngle, step, count, sines, cosines);
+#endif
+#if defined(SINCOS_SSE2)
+    if (path == SINCOS_PATH_SSE2) i = ringSinCosSSE2(startAngle, step, count, sines, cosines);
+#endif
+
+    for (; i < count; i++) {
+        sinCosScalar(startAngle + (float)i * step, sines + i, cosines + i);
+    }
+}
+
+void ringSinCos(float startAngle, float step, int count, float* sines, float* cosines) {
+    ringSinCosPath(defaultSinCosPath(), startAngle, step, count, sines, cosines);
+}
+
+double ringSinCosMaxError(SinCosPath path, float startAngle, float step, int count) {
+    // chunks of an odd size, so every chunk also runs the scalar tail
+    const int chunk = 1021;
+    float sines[chunk], cosines[chunk];
+
+    double maxError = 0.0;
+    for (int first = 0; first < count; first += chunk) {
+        int n = count - first < chunk ? count - first : chunk;
+        float start = startAngle + (float)first * step;
+        ringSinCosPath(path, start, step, n, sines, cosines);
+        for (int i = 0; i < n; i++) {
+            double angle = (double)(start + (float)i * step);
+            maxError = std::fmax(maxError, std::fabs(sines[i] - std::sin(angle)));
+            maxError = std::fmax(maxError, std::fabs(cosines[i] - std::cos(angle)));
+        }
+    }
+    return maxError;
+}
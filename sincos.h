@@ -0,0 +1,28 @@
+#ifndef SINCOS_H
+#define SINCOS_H
+
+// float sin/cos of evenly spaced angles, startAngle + i * step for i in [0, count)
+// AVX2 or SSE2 when the compiler targets them, scalar otherwise; all paths use the
+// same range reduction and polynomials, max abs error vs std::sin/std::cos is below 1e-7 for |angle| < 1e4
+#define SINCOS_MAX_ERROR 1e-7
+
+enum SinCosPath {
+    SINCOS_PATH_SCALAR,
+    SINCOS_PATH_SSE2,
+    SINCOS_PATH_AVX2
+};
+
+void ringSinCos(float startAngle, float step, int count, float* sines, float* cosines);
+
+// a specific kernel, for the self-test; the path must be available
+void ringSinCosPath(SinCosPath path, float startAngle, float step, int count, float* sines, float* cosines);
+// compiled into this build and supported by this CPU
+bool sinCosPathAvailable(SinCosPath path);
+// the path ringSinCos takes
+SinCosPath defaultSinCosPath();
+const char* sinCosPathName(SinCosPath path);
+
+// max abs error of one path against double-precision std::sin/std::cos over count angles
+double ringSinCosMaxError(SinCosPath path, float startAngle, float step, int count);
+
+#endif
@@ -0,0 +1,421 @@
+#include "softraster.h"
+#include "arena.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTRASTER_SSE2
+#endif
+
+// 24.8: llvmpipe keeps vertices finer than 1/16 pixel, 4 bits left visible edge differences
+#define SUBPIXEL_BITS 8
+#define SUBPIXEL_ONE (1 << SUBPIXEL_BITS)
+
+static void runTiles(SoftRasterizer& raster);
+
+static void workerLoop(SoftRasterizer* raster) {
+    int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(raster->mutex);
+            raster->wake.wait(lock, [&] { return raster->quit || raster->generation != seen; });
+            if (raster->quit) return;
+            seen = raster->generation;
+        }
+
+        runTiles(*raster);
+
+        std::lock_guard<std::mutex> lock(raster->mutex);
+        if (--raster->busy == 0) raster->done.notify_one();
+    }
+}
+
+bool createSoftRasterizer(SoftRasterizer& raster, int width, int height, int threads) {
+    if (width <= 0 || height <= 0 || width > SOFT_MAX_SIZE || height > SOFT_MAX_SIZE) {
+        std::cout << "ERROR::SOFTRASTER::UNSUPPORTED_SIZE " << width << "x" << height << std::endl;
+        return false;
+    }
+
+    raster.width = width;
+    raster.height = height;
+    raster.tilesX = (width + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    raster.tilesY = (height + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    raster.pixels.assign((size_t)width * height * 4, 0);
+    raster.bins.assign((size_t)raster.tilesX * raster.tilesY, std::vector<unsigned int>());
+    raster.triangles.clear();
+
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    raster.quit = false;
+    for (int i = 1; i < threads; i++) {
+        raster.workers.emplace_back(workerLoop, &raster);
+    }
+    return true;
+}
+
+void deleteSoftRasterizer(SoftRasterizer& raster) {
+    {
+        std::lock_guard<std::mutex> lock(raster.mutex);
+        raster.quit = true;
+    }
+    raster.wake.notify_all();
+    for (std::thread& worker : raster.workers) worker.join();
+    raster.workers.clear();
+
+    raster.pixels.clear();
+    raster.triangles.clear();
+    raster.bins.clear();
+}
+
+void softClear(SoftRasterizer& raster, Color color) {
+    unsigned int r = (unsigned int)lrintf(std::min(std::max(color.r, 0.0f), 1.0f) * 255.0f);
+    unsigned int g = (unsigned int)lrintf(std::min(std::max(color.g, 0.0f), 1.0f) * 255.0f);
+    unsigned int b = (unsigned int)lrintf(std::min(std::max(color.b, 0.0f), 1.0f) * 255.0f);
+    raster.clearColor = r | (g << 8) | (b << 16) | 0xFF000000u;
+    raster.clearPending = true;
+
+    // anything queued before the clear would be overwritten anyway
+    raster.triangles.clear();
+    for (std::vector<unsigned int>& bin : raster.bins) bin.clear();
+}
+
+// NDC to 24.8 fixed point window coordinates, y up like GL
+static bool toFixed(const SoftRasterizer& raster, const float* vertex, int& x, int& y) {
+    float fx = (vertex[0] + 1.0f) * 0.5f * raster.width;
+    float fy = (vertex[1] + 1.0f) * 0.5f * raster.height;
+    if (fx < -SOFT_GUARD_BAND || fx > raster.width + SOFT_GUARD_BAND ||
+        fy < -SOFT_GUARD_BAND || fy > raster.height + SOFT_GUARD_BAND) {
+        return false;
+    }
+    x = (int)lrintf(fx * SUBPIXEL_ONE);
+    y = (int)lrintf(fy * SUBPIXEL_ONE);
+    return true;
+}
+
+static void setupTriangle(SoftRasterizer& raster, const float* v0, const float* v1, const float* v2) {
+    const float* v[3] = { v0, v1, v2 };
+    int x[3], y[3];
+    for (int i = 0; i < 3; i++) {
+        if (!toFixed(raster, v[i], x[i], y[i])) return;
+    }
+
+    long long area = (long long)(x[1] - x[0]) * (y[2] - y[0]) - (long long)(x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0) return;
+    if (area < 0) {
+        // no culling, clockwise triangles are flipped to counter-clockwise
+        std::swap(v[1], v[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        area = -area;
+    }
+
+    SoftTriangle tri;
+    int minXs = std::min(x[0], std::min(x[1], x[2])), maxXs = std::max(x[0], std::max(x[1], x[2]));
+    int minYs = std::min(y[0], std::min(y[1], y[2])), maxYs = std::max(y[0], std::max(y[1], y[2]));
+    const int half = SUBPIXEL_ONE / 2;
+    tri.minX = std::max(0, (minXs - half + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS);
+    tri.minY = std::max(0, (minYs - half + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS);
+    tri.maxX = std::min(raster.width - 1, (maxXs - half) >> SUBPIXEL_BITS);
+    tri.maxY = std::min(raster.height - 1, (maxYs - half) >> SUBPIXEL_BITS);
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+    // E(p) = (b - a) x (p - a), positive inside a counter-clockwise triangle,
+    // evaluated at pixel centres; edges that are neither top nor left must be > 0
+    // "top" as GL rasterizers apply it: the rule is defined with y down, so in these
+    // y-up window coordinates the horizontal edge that owns its centres is the bottom one
+    // pixel centres are SUBPIXEL_ONE apart, so E steps by A * SUBPIXEL_ONE per pixel;
+    // floor(E / SUBPIXEL_ONE) steps by exactly A and has the same sign, so that is
+    // what is stored, keeping the per-pixel steps at subpixel size
+    for (int i = 0; i < 3; i++) {
+        int j = (i + 1) % 3;
+        int dx = x[j] - x[i], dy = y[j] - y[i];
+        long long A = -dy, B = dx;
+        long long C = -(A * x[i] + B * y[i]);
+        bool topLeft = (dy < 0) || (dy == 0 && dx > 0);
+
+        long long e = C + (A + B) * half + (topLeft ? 0 : -1);
+        tri.a[i] = (int)A;
+        tri.b[i] = (int)B;
+        tri.c[i] = (e >= 0) ? e / SUBPIXEL_ONE : -((-e + SUBPIXEL_ONE - 1) / SUBPIXEL_ONE);
+    }
+
+    // colour planes over pixel coordinates
+    float fx[3], fy[3];
+    for (int i = 0; i < 3; i++) {
+        fx[i] = (float)x[i] / SUBPIXEL_ONE;
+        fy[i] = (float)y[i] / SUBPIXEL_ONE;
+    }
+    float det = (float)area / (SUBPIXEL_ONE * SUBPIXEL_ONE);
+    for (int k = 0; k < 3; k++) {
+        float c0 = v[0][2 + k], c1 = v[1][2 + k], c2 = v[2][2 + k];
+        float dcdx = ((c1 - c0) * (fy[2] - fy[0]) - (c2 - c0) * (fy[1] - fy[0])) / det;
+        float dcdy = ((c2 - c0) * (fx[1] - fx[0]) - (c1 - c0) * (fx[2] - fx[0])) / det;
+        tri.color[k][0] = c0 + dcdx * (0.5f - fx[0]) + dcdy * (0.5f - fy[0]);
+        tri.color[k][1] = dcdx;
+        tri.color[k][2] = dcdy;
+    }
+
+    unsigned int id = (unsigned int)raster.triangles.size();
+    raster.triangles.push_back(tri);
+
+    int tileX0 = tri.minX / SOFT_TILE_SIZE, tileX1 = tri.maxX / SOFT_TILE_SIZE;
+    int tileY0 = tri.minY / SOFT_TILE_SIZE, tileY1 = tri.maxY / SOFT_TILE_SIZE;
+    for (int ty = tileY0; ty <= tileY1; ty++) {
+        for (int tx = tileX0; tx <= tileX1; tx++) {
+            raster.bins[(size_t)ty * raster.tilesX + tx].push_back(id);
+        }
+    }
+}
+
+// one side of the guard band: keeps points with sign * p[axis] <= limit
+struct ClipPlane {
+    int axis;
+    float sign, limit;
+};
+
+// clips against each guard band side in turn, interpolating position and colour;
+// a triangle gains at most one vertex per side
+static int clipPolygon(const float* in, int count, float* out, const ClipPlane& plane) {
+    int outCount = 0;
+    for (int i = 0; i < count; i++) {
+        const float* a = in + i * 5;
+        const float* b = in + ((i + 1) % count) * 5;
+        float da = plane.sign * a[plane.axis] - plane.limit;
+        float db = plane.sign * b[plane.axis] - plane.limit;
+
+        if (da <= 0.0f) {
+            memcpy(out + outCount++ * 5, a, 5 * sizeof(float));
+        }
+        if ((da <= 0.0f) != (db <= 0.0f)) {
+            float t = da / (da - db);
+            float* v = out + outCount++ * 5;
+            for (int k = 0; k < 5; k++) v[k] = a[k] + (b[k] - a[k]) * t;
+            v[plane.axis] = plane.sign * plane.limit;
+        }
+    }
+    return outCount;
+}
+
+// triangles reaching past the guard band are clipped to it and drawn as a fan;
+// the new edges lie outside the target, so no visible pixel depends on them
+static void drawTriangle(SoftRasterizer& raster, const float* v0, const float* v1, const float* v2) {
+    // guard band in NDC, one pixel inside so rounding cannot push a clipped vertex out
+    float bandX = 1.0f + 2.0f * (SOFT_GUARD_BAND - 1) / raster.width;
+    float bandY = 1.0f + 2.0f * (SOFT_GUARD_BAND - 1) / raster.height;
+
+    const float* v[3] = { v0, v1, v2 };
+    bool inside = true;
+    for (int i = 0; i < 3; i++) {
+        inside = inside && std::fabs(v[i][0]) <= bandX && std::fabs(v[i][1]) <= bandY;
+    }
+    if (inside) {
+        setupTriangle(raster, v0, v1, v2);
+        return;
+    }
+
+    const ClipPlane planes[4] = { { 0, 1.0f, bandX }, { 0, -1.0f, bandX }, { 1, 1.0f, bandY }, { 1, -1.0f, bandY } };
+    float polygon[2][7 * 5];
+    memcpy(polygon[0], v0, 5 * sizeof(float));
+    memcpy(polygon[0] + 5, v1, 5 * sizeof(float));
+    memcpy(polygon[0] + 10, v2, 5 * sizeof(float));
+    int count = 3, current = 0;
+    for (const ClipPlane& plane : planes) {
+        count = clipPolygon(polygon[current], count, polygon[1 - current], plane);
+        current = 1 - current;
+        if (count < 3) return;
+    }
+
+    for (int i = 1; i + 1 < count; i++) {
+        setupTriangle(raster, polygon[current], polygon[current] + i * 5, polygon[current] + (i + 1) * 5);
+    }
+}
+
+void softDrawTriangles(SoftRasterizer& raster, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) continue;
+        drawTriangle(raster, vertices + indices[i] * 5, vertices + indices[i + 1] * 5, vertices + indices[i + 2] * 5);
+    }
+}
+
+void softDrawInstanced(SoftRasterizer& raster, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                       const Instance* instances, size_t instanceCount) {
+    float* placed = arenaArray<float>(frameArena(), vertexCount * 5);
+    for (size_t n = 0; n < instanceCount; n++) {
+        const Instance& instance = instances[n];
+        float c = cosf(instance.rotation), s = sinf(instance.rotation);
+        for (size_t i = 0; i < vertexCount; i++) {
+            const float* src = vertices + i * 5;
+            float* dst = placed + i * 5;
+            float px = src[0] * instance.scaleX, py = src[1] * instance.scaleY;
+            dst[0] = instance.centerX + c * px - s * py;
+            dst[1] = instance.centerY + s * px + c * py;
+            dst[2] = src[2] * instance.color.r;
+            dst[3] = src[3] * instance.color.g;
+            dst[4] = src[4] * instance.color.b;
+        }
+        softDrawTriangles(raster, placed, vertexCount, indices, indexCount);
+    }
+}
+
+static inline unsigned int packColor(float r, float g, float b) {
+    unsigned int ir = (unsigned int)(std::min(std::max(r, 0.0f), 1.0f) * 255.0f + 0.5f);
+    unsigned int ig = (unsigned int)(std::min(std::max(g, 0.0f), 1.0f) * 255.0f + 0.5f);
+    unsigned int ib = (unsigned int)(std::min(std::max(b, 0.0f), 1.0f) * 255.0f + 0.5f);
+    return ir | (ig << 8) | (ib << 16) | 0xFF000000u;
+}
+
+#if defined(SOFTRASTER_SSE2)
+static inline __m128i packColor4(__m128 r, __m128 g, __m128 b) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), scale = _mm_set1_ps(255.0f), round = _mm_set1_ps(0.5f);
+    __m128i ir = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(r, zero), one), scale), round));
+    __m128i ig = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(g, zero), one), scale), round));
+    __m128i ib = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(b, zero), one), scale), round));
+    __m128i rgba = _mm_or_si128(ir, _mm_slli_epi32(ig, 8));
+    rgba = _mm_or_si128(rgba, _mm_slli_epi32(ib, 16));
+    return _mm_or_si128(rgba, _mm_set1_epi32((int)0xFF000000u));
+}
+#endif
+
+// fills one triangle inside the tile rectangle [x0, x1] x [y0, y1]
+static void rasterizeInTile(unsigned int* pixels, int stride, const SoftTriangle& tri, int x0, int y0, int x1, int y1) {
+    x0 = std::max(x0, tri.minX);
+    y0 = std::max(y0, tri.minY);
+    x1 = std::min(x1, tri.maxX);
+    y1 = std::min(y1, tri.maxY);
+    if (x0 > x1 || y0 > y1) return;
+
+    // per edge: whole rectangle inside (skip the test), outside (nothing to draw), or crossing
+    // a crossing edge stays within (|a| + |b|) * (SOFT_TILE_SIZE + 4) of zero, the 4 being the
+    // SSE2 overshoot; vertices lie inside the guard band, so |a| + |b| is at most
+    // 2 * (size + 2 * SOFT_GUARD_BAND) * SUBPIXEL_ONE and int32 holds targets up to SOFT_MAX_SIZE
+    int rowStart[3], stepX[3], stepY[3];
+    for (int i = 0; i < 3; i++) {
+        long long e00 = tri.c[i] + (long long)tri.a[i] * x0 + (long long)tri.b[i] * y0;
+        long long e10 = e00 + (long long)tri.a[i] * (x1 - x0);
+        long long e01 = e00 + (long long)tri.b[i] * (y1 - y0);
+        long long e11 = e10 + (long long)tri.b[i] * (y1 - y0);
+        long long lo = std::min(std::min(e00, e10), std::min(e01, e11));
+        long long hi = std::max(std::max(e00, e10), std::max(e01, e11));
+        if (hi < 0) return;
+
+        if (lo >= 0) {
+            rowStart[i] = stepX[i] = stepY[i] = 0;
+        } else {
+            rowStart[i] = (int)e00;
+            stepX[i] = tri.a[i];
+            stepY[i] = tri.b[i];
+        }
+    }
+
+    float colorRow[3];
+    for (int k = 0; k < 3; k++) {
+        colorRow[k] = tri.color[k][0] + tri.color[k][1] * x0 + tri.color[k][2] * y0;
+    }
+
+#if defined(SOFTRASTER_SSE2)
+    const __m128 laneF = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128i stepX4[3], laneStep[3];
+    for (int i = 0; i < 3; i++) {
+        stepX4[i] = _mm_set1_epi32(stepX[i] * 4);
+        // lane offsets set up once, SSE2 has no 32-bit mullo
+        laneStep[i] = _mm_setr_epi32(0, stepX[i], stepX[i] * 2, stepX[i] * 3);
+    }
+    __m128 dR = _mm_set1_ps(tri.color[0][1]), dG = _mm_set1_ps(tri.color[1][1]), dB = _mm_set1_ps(tri.color[2][1]);
+#endif
+
+    for (int y = y0; y <= y1; y++) {
+        unsigned int* row = pixels + (size_t)y * stride;
+        int e0 = rowStart[0], e1 = rowStart[1], e2 = rowStart[2];
+        float r = colorRow[0], g = colorRow[1], b = colorRow[2];
+        int x = x0;
+
+#if defined(SOFTRASTER_SSE2)
+        __m128i v0 = _mm_add_epi32(_mm_set1_epi32(e0), laneStep[0]);
+        __m128i v1 = _mm_add_epi32(_mm_set1_epi32(e1), laneStep[1]);
+        __m128i v2 = _mm_add_epi32(_mm_set1_epi32(e2), laneStep[2]);
+        for (; x + 3 <= x1; x += 4) {
+            // sign bit set in any edge = outside
+            __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(v0, v1), v2), 31);
+            if (_mm_movemask_epi8(outside) != 0xFFFF) {
+                float offset = (float)(x - x0);
+                __m128 dx = _mm_add_ps(_mm_set1_ps(offset), laneF);
+                __m128 rv = _mm_add_ps(_mm_set1_ps(r), _mm_mul_ps(dR, dx));
+                __m128 gv = _mm_add_ps(_mm_set1_ps(g), _mm_mul_ps(dG, dx));
+                __m128 bv = _mm_add_ps(_mm_set1_ps(b), _mm_mul_ps(dB, dx));
+                __m128i color = packColor4(rv, gv, bv);
+                __m128i dst = _mm_loadu_si128((const __m128i*)(row + x));
+                dst = _mm_or_si128(_mm_and_si128(outside, dst), _mm_andnot_si128(outside, color));
+                _mm_storeu_si128((__m128i*)(row + x), dst);
+            }
+            v0 = _mm_add_epi32(v0, stepX4[0]);
+            v1 = _mm_add_epi32(v1, stepX4[1]);
+            v2 = _mm_add_epi32(v2, stepX4[2]);
+        }
+        e0 += stepX[0] * (x - x0);
+        e1 += stepX[1] * (x - x0);
+        e2 += stepX[2] * (x - x0);
+#endif
+
+        for (; x <= x1; x++) {
+            if ((e0 | e1 | e2) >= 0) {
+                float offset = (float)(x - x0);
+                row[x] = packColor(r + tri.color[0][1] * offset, g + tri.color[1][1] * offset, b + tri.color[2][1] * offset);
+            }
+            e0 += stepX[0];
+            e1 += stepX[1];
+            e2 += stepX[2];
+        }
+
+        for (int i = 0; i < 3; i++) rowStart[i] += stepY[i];
+        for (int k = 0; k < 3; k++) colorRow[k] += tri.color[k][2];
+    }
+}
+
+static void rasterizeTile(SoftRasterizer& raster, int tile) {
+    int tx = tile % raster.tilesX, ty = tile / raster.tilesX;
+    int x0 = tx * SOFT_TILE_SIZE, y0 = ty * SOFT_TILE_SIZE;
+    int x1 = std::min(x0 + SOFT_TILE_SIZE, raster.width) - 1;
+    int y1 = std::min(y0 + SOFT_TILE_SIZE, raster.height) - 1;
+    unsigned int* pixels = (unsigned int*)raster.pixels.data();
+
+    if (raster.clearPending) {
+        for (int y = y0; y <= y1; y++) {
+            std::fill(pixels + (size_t)y * raster.width + x0, pixels + (size_t)y * raster.width + x1 + 1, raster.clearColor);
+        }
+    }
+
+    // bins keep submission order, so later triangles overwrite earlier ones like in GL
+    for (unsigned int id : raster.bins[tile]) {
+        rasterizeInTile(pixels, raster.width, raster.triangles[id], x0, y0, x1, y1);
+    }
+}
+
+static void runTiles(SoftRasterizer& raster) {
+    int tileCount = raster.tilesX * raster.tilesY;
+    for (int tile = raster.nextTile++; tile < tileCount; tile = raster.nextTile++) {
+        rasterizeTile(raster, tile);
+    }
+}
+
+void softFlush(SoftRasterizer& raster) {
+    raster.nextTile = 0;
+    if (!raster.workers.empty()) {
+        std::lock_guard<std::mutex> lock(raster.mutex);
+        raster.busy = (int)raster.workers.size();
+        raster.generation++;
+    }
+    raster.wake.notify_all();
+
+    runTiles(raster);
+
+    if (!raster.workers.empty()) {
+        std::unique_lock<std::mutex> lock(raster.mutex);
+        raster.done.wait(lock, [&] { return raster.busy == 0; });
+    }
+
+    raster.clearPending = false;
+    raster.triangles.clear();
+    for (std::vector<unsigned int>& bin : raster.bins) bin.clear();
+}
@@ -0,0 +1,64 @@
+#ifndef SOFTRASTER_H
+#define SOFTRASTER_H
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include "shapes.h"
+#include "instancing.h"
+
+// CPU rasterizer for the flat, vertex-coloured task scenes, no GL needed
+// consumes the same [x, y, r, g, b] NDC vertices and triangle lists as the GL path;
+// triangles are set up in 24.8 fixed point and binned into SOFT_TILE_SIZE tiles in
+// submission order, then tiles are filled in parallel with SSE2 edge functions and
+// GL's top-left fill rule, so shared edges are drawn exactly once and pixel centres
+// exactly on an edge go the same way as on llvmpipe
+#define SOFT_TILE_SIZE 64
+
+// triangles reaching more than this many pixels outside the target are clipped to it
+#define SOFT_GUARD_BAND 4096
+// largest target side; keeps the per-tile edge stepping in int32 (see rasterizeInTile)
+#define SOFT_MAX_SIZE 32768
+
+struct SoftTriangle {
+    int minX, minY, maxX, maxY; // covered pixels, inclusive, clipped to the target
+    int a[3], b[3];             // edge function steps per pixel in x and y, over SUBPIXEL_ONE
+    long long c[3];             // edge value at pixel (0, 0) over SUBPIXEL_ONE, floored, top-left bias included
+    float color[3][3];          // r, g, b: value at pixel (0, 0), d/dx, d/dy
+};
+
+struct SoftRasterizer {
+    int width = 0, height = 0;
+    int tilesX = 0, tilesY = 0;
+    std::vector<unsigned char> pixels; // RGBA8, bottom row first like glReadPixels
+
+    std::vector<SoftTriangle> triangles;
+    std::vector<std::vector<unsigned int>> bins; // triangle ids per tile
+    bool clearPending = false;
+    unsigned int clearColor = 0;
+
+    // tile workers, the calling thread works too
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    int generation = 0, busy = 0;
+    bool quit = false;
+    std::atomic<int> nextTile{ 0 };
+};
+
+// threads <= 0 uses every hardware thread; false for sides above SOFT_MAX_SIZE
+bool createSoftRasterizer(SoftRasterizer& raster, int width, int height, int threads);
+void deleteSoftRasterizer(SoftRasterizer& raster);
+
+void softClear(SoftRasterizer& raster, Color color);
+void softDrawTriangles(SoftRasterizer& raster, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+// same placement and tint as the instanced shader
+void softDrawInstanced(SoftRasterizer& raster, const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                       const Instance* instances, size_t instanceCount);
+
+// rasterizes everything drawn since the last flush into pixels
+void softFlush(SoftRasterizer& raster);
+
+#endif
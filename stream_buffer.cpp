@@ -0,0 +1,209 @@
+#include "stream_buffer.h"
+#include "gl_state.h"
+#include "frame_stats.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+bool createStreamBuffer(StreamBuffer& stream, size_t regionSize, bool allowPersistent) {
+    stream = StreamBuffer();
+    stream.regionSize = regionSize;
+    stream.persistent = allowPersistent && glBufferStorage != NULL &&
+                        (hasGLVersion(4, 4) || hasGLExtension("GL_ARB_buffer_storage"));
+
+    // the buffer is only ever bound to GL_ARRAY_BUFFER for setup and mapping, the
+    // element binding belongs to the VAO
+    GLsizeiptr size = (GLsizeiptr)regionSize * STREAM_REGIONS;
+    glGenBuffers(1, &stream.buffer);
+    cachedBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+
+    if (stream.persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        stream.mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (stream.mapped == NULL) {
+            std::cout << "ERROR::STREAM_BUFFER::MAP_FAILED " << size << " bytes" << std::endl;
+            deleteStreamBuffer(stream);
+            return false;
+        }
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+    }
+    return true;
+}
+
+void deleteStreamBuffer(StreamBuffer& stream) {
+    for (int i = 0; i < STREAM_REGIONS; i++) {
+        if (stream.fences[i]) glDeleteSync(stream.fences[i]);
+        stream.fences[i] = 0;
+    }
+    if (stream.mapped) {
+        cachedBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        stream.mapped = NULL;
+    }
+    forgetBuffers(1, &stream.buffer);
+    glDeleteBuffers(1, &stream.buffer);
+    stream.buffer = 0;
+}
+
+void beginStreamFrame(StreamBuffer& stream) {
+    stream.region = (stream.region + 1) % STREAM_REGIONS;
+    stream.used = 0;
+
+    GLsync fence = stream.fences[stream.region];
+    if (fence == 0) return;
+
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        auto start = std::chrono::steady_clock::now();
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        }
+        stream.stats.waits++;
+        stream.stats.waitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (status == GL_WAIT_FAILED) {
+        std::cout << "ERROR::STREAM_BUFFER::WAIT_FAILED region " << stream.region << std::endl;
+    }
+
+    glDeleteSync(fence);
+    stream.fences[stream.region] = 0;
+}
+
+void endStreamFrame(StreamBuffer& stream) {
+    if (stream.fences[stream.region]) glDeleteSync(stream.fences[stream.region]);
+    stream.fences[stream.region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* streamMap(StreamBuffer& stream, size_t size, size_t alignment, size_t* offset) {
+    size_t regionStart = stream.region * stream.regionSize;
+    size_t start = (regionStart + stream.used + alignment - 1) / alignment * alignment;
+    if (start + size > regionStart + stream.regionSize) {
+        std::cout << "ERROR::STREAM_BUFFER::REGION_FULL " << size << " bytes at offset " << start
+                  << ", region " << stream.region << " has " << stream.regionSize << std::endl;
+        return NULL;
+    }
+
+    void* target = NULL;
+    if (stream.persistent) {
+        target = stream.mapped + start;
+    } else {
+        cachedBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+        GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        target = glMapBufferRange(GL_ARRAY_BUFFER, start, size, access);
+        if (target == NULL) {
+            std::cout << "ERROR::STREAM_BUFFER::MAP_FAILED " << size << " bytes at offset " << start << std::endl;
+            return NULL;
+        }
+    }
+
+    stream.used = start + size - regionStart;
+    stream.stats.bytes += size;
+    *offset = start;
+    return target;
+}
+
+void streamUnmap(StreamBuffer& stream) {
+    // coherent persistent writes are visible to every command issued after them
+    if (stream.persistent) return;
+
+    cachedBindBuffer(GL_ARRAY_BUFFER, stream.buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+static bool createStreams(StreamBatch& batch, size_t vertexBytes, size_t indexBytes) {
+    if (!createStreamBuffer(batch.vertices, vertexBytes, batch.allowPersistent)) return false;
+    if (!createStreamBuffer(batch.indices, indexBytes, batch.allowPersistent)) {
+        deleteStreamBuffer(batch.vertices);
+        return false;
+    }
+
+    cachedBindVertexArray(batch.VAO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, batch.vertices.buffer);
+    applyVertexFormat(*batch.vertexFormat);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.indices.buffer);
+    cachedBindVertexArray(0);
+    return true;
+}
+
+bool createStreamBatch(StreamBatch& batch, size_t vertexBytes, size_t indexBytes) {
+    glGenVertexArrays(1, &batch.VAO);
+    return createStreams(batch, vertexBytes, indexBytes);
+}
+
+// copies bytes into the next free, aligned spot of the stream
+static bool streamWrite(StreamBuffer& stream, const void* data, size_t size, size_t alignment, size_t* offset) {
+    void* target = streamMap(stream, size, alignment, offset);
+    if (target == NULL) return false;
+    memcpy(target, data, size);
+    streamUnmap(stream);
+    return true;
+}
+
+bool streamShapes(StreamBatch& batch, const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+    // staged in the frame arena, which is reset once the frame is submitted
+    Arena& arena = frameArena();
+    size_t stride = batch.vertexFormat->stride;
+    size_t vertexBytes = vertices.size() / 5 * stride;
+    unsigned char* encoded = arenaArray<unsigned char>(arena, vertexBytes);
+    encodeVertices(*batch.vertexFormat, vertices.data(), vertices.size() / 5, encoded);
+    PackedIndices packed;
+    packIndices(indices.data(), indices.size(), arena, packed);
+    size_t indexBytes = packed.bytes;
+
+    // alignment padding included; a frame that does not fit grows both rings, the old
+    // buffers stay alive in the driver until the GPU is done with them
+    if (vertexBytes + stride > batch.vertices.regionSize || indexBytes + 4 > batch.indices.regionSize) {
+        StreamBufferStats vertexStats = batch.vertices.stats, indexStats = batch.indices.stats;
+        size_t vertexRegion = std::max(batch.vertices.regionSize, (vertexBytes + stride) * 3 / 2);
+        size_t indexRegion = std::max(batch.indices.regionSize, (indexBytes + 4) * 3 / 2);
+        deleteStreamBuffer(batch.vertices);
+        deleteStreamBuffer(batch.indices);
+        if (!createStreams(batch, vertexRegion, indexRegion)) return false;
+        batch.vertices.stats = vertexStats;
+        batch.indices.stats = indexStats;
+    }
+
+    beginStreamFrame(batch.vertices);
+    beginStreamFrame(batch.indices);
+
+    size_t vertexOffset = 0;
+    if (!streamWrite(batch.vertices, encoded, vertexBytes, stride, &vertexOffset) ||
+        !streamWrite(batch.indices, packed.data, indexBytes, indexSize(packed.format.type), &batch.indexOffset)) {
+        // streamMap has said why: the region is full or the map failed
+        batch.indexCount = 0;
+        return false;
+    }
+
+    batch.baseVertex = (GLint)(vertexOffset / stride);
+    batch.indexFormat = packed.format;
+    batch.indexCount = packed.count;
+    batch.vertexBytes = vertexBytes;
+    batch.indexBytes = indexBytes;
+    return true;
+}
+
+void drawStreamBatch(const StreamBatch& batch) {
+    if (batch.indexCount == 0) return;
+
+    beginTimedDraw();
+    cachedBindVertexArray(batch.VAO);
+    drawIndexedBaseVertex(batch.indexFormat, batch.indexCount, batch.indexOffset, batch.baseVertex);
+    endTimedDraw((long long)(batch.vertexBytes / batch.vertexFormat->stride));
+}
+
+void endStreamBatchFrame(StreamBatch& batch) {
+    endStreamFrame(batch.vertices);
+    endStreamFrame(batch.indices);
+}
+
+void deleteStreamBatch(StreamBatch& batch) {
+    deleteStreamBuffer(batch.vertices);
+    deleteStreamBuffer(batch.indices);
+    forgetVertexArray(batch.VAO);
+    glDeleteVertexArrays(1, &batch.VAO);
+    batch.VAO = 0;
+    batch.indexCount = 0;
+}
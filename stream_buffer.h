@@ -0,0 +1,74 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+#include "gl_loader.h"
+#include <vector>
+#include <cstddef>
+#include "index_buffer.h"
+#include "vertex_format.h"
+
+// ring for data the CPU rewrites every frame: one buffer split into STREAM_REGIONS regions,
+// frame N writes region N % STREAM_REGIONS while the GPU may still read the other two
+// endStreamFrame fences the region; beginStreamFrame waits on that fence only when the
+// ring comes back around, i.e. when the GPU is STREAM_REGIONS frames behind
+// with GL 4.4 / GL_ARB_buffer_storage the buffer is mapped once, persistent and coherent;
+// on plain 3.3 each streamMap is a glMapBufferRange with UNSYNCHRONIZED | INVALIDATE_RANGE,
+// safe because the fence already proved the GPU is done with that range
+#define STREAM_REGIONS 3
+
+struct StreamBufferStats {
+    long long bytes = 0;
+    long long waits = 0; // frames whose region was still in use
+    double waitMs = 0.0;
+};
+
+struct StreamBuffer {
+    GLuint buffer = 0;
+    size_t regionSize = 0;
+    bool persistent = false;
+    unsigned char* mapped = NULL; // whole buffer, persistent only
+    GLsync fences[STREAM_REGIONS] = {};
+    int region = STREAM_REGIONS - 1;
+    size_t used = 0; // bytes taken from the current region
+    StreamBufferStats stats;
+};
+
+// allowPersistent = false forces the glMapBufferRange path even where buffer storage exists
+bool createStreamBuffer(StreamBuffer& stream, size_t regionSize, bool allowPersistent);
+void deleteStreamBuffer(StreamBuffer& stream);
+
+void beginStreamFrame(StreamBuffer& stream);
+void endStreamFrame(StreamBuffer& stream);
+
+// size bytes at an alignment-aligned offset from the buffer start; NULL, with REGION_FULL or
+// MAP_FAILED printed, if the region has no room or glMapBufferRange fails
+// every streamMap must be closed with streamUnmap before a draw reads the data
+void* streamMap(StreamBuffer& stream, size_t size, size_t alignment, size_t* offset);
+void streamUnmap(StreamBuffer& stream);
+
+// per-frame triangle lists drawn straight from two stream buffers
+// the VAO points at offset 0 of the vertex stream; each frame is addressed through the
+// index offset and glDrawElementsBaseVertex, so attribute pointers are set once
+struct StreamBatch {
+    StreamBuffer vertices, indices;
+    const VertexFormat* vertexFormat = &floatVertexFormat;
+    bool allowPersistent = true;
+
+    GLuint VAO = 0;
+    IndexFormat indexFormat;
+    GLsizei indexCount = 0;
+    size_t indexOffset = 0;
+    GLint baseVertex = 0;
+
+    size_t vertexBytes = 0, indexBytes = 0; // streamed by the last streamShapes
+};
+
+// region sizes are a first guess, the batch grows when a frame does not fit
+bool createStreamBatch(StreamBatch& batch, size_t vertexBytes, size_t indexBytes);
+// starts the frame: vertices are [x, y, r, g, b], indices a triangle list
+bool streamShapes(StreamBatch& batch, const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
+void drawStreamBatch(const StreamBatch& batch);
+// after the frame's draws
+void endStreamBatchFrame(StreamBatch& batch);
+void deleteStreamBatch(StreamBatch& batch);
+
+#endif
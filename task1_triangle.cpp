@@ -1,48 +1,26 @@
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
-#include <iostream>
+#include "gl_loader.h"
+#include "gl_state.h"
+#include "scenes.h"
+#include "frame_stats.h"
+#include "program_cache.h"
 
-int triangle_main() {
-    
-
-    if (!glfwInit()) {
-        std::cout << "Failed to initialize GLFW" << std::endl;
-        return -1;
-    }
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(500, 500, "Red Triangle", NULL, NULL);
-    if (!window) {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-
-    glfwMakeContextCurrent(window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        return -1;
-    }
+static unsigned int VAO, VBO, shaderProgram;
 
+static bool triangle_init() {
     float vertices[] = {
         -0.5f, -0.5f, 0.0f,  
          0.5f, -0.5f, 0.0f,
          0.0f,  0.5f, 0.0f   
     };
 
-    unsigned int VAO, VBO;
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    cachedBindVertexArray(VAO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    cachedEnableVertexAttribArray(0);
 
     const char* vertexShaderSource = R"(
     #version 330 core
@@ -56,38 +34,27 @@ int triangle_main() {
     void main() { FragColor = vec4(1.0, 0.0, 0.0, 1.0); }
     )";
 
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    shaderProgram = getCachedProgram(vertexShaderSource, fragmentShaderSource);
 
-    while (!glfwWindowShouldClose(window)) {
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+    return true;
+}
 
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
+static void triangle_draw() {
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+    cachedUseProgram(shaderProgram);
+    beginTimedDraw();
+    cachedBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    endTimedDraw(3);
+}
 
+static void triangle_cleanup() {
+    forgetVertexArray(VAO);
+    forgetBuffers(1, &VBO);
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+}
 
-    glfwTerminate();
-    return 0;
-}
\ No newline at end of file
+const Scene triangleScene = { "triangle", "Red Triangle", triangle_init, triangle_draw, triangle_cleanup };
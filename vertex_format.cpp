@@ -0,0 +1,91 @@
+#include "vertex_format.h"
+#include "gl_state.h"
+#include <cstring>
+#include <cmath>
+
+const VertexFormat floatVertexFormat = {
+    "float", 5 * sizeof(float), 2,
+    {
+        { 0, 2, GL_FLOAT, GL_FALSE, 0, 0, 2 },
+        { 1, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(float), 2, 3 }
+    }
+};
+
+// colour keeps an opaque alpha byte so every vertex stays 4-byte aligned
+const VertexFormat packedVertexFormat = {
+    "packed", 2 * sizeof(short) + 4, 2,
+    {
+        { 0, 2, GL_SHORT, GL_TRUE, 0, 0, 2 },
+        { 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 2 * sizeof(short), 2, 3 }
+    }
+};
+
+const VertexFormat* findVertexFormat(const char* name) {
+    if (strcmp(name, floatVertexFormat.name) == 0) return &floatVertexFormat;
+    if (strcmp(name, packedVertexFormat.name) == 0) return &packedVertexFormat;
+    return NULL;
+}
+
+static short toSnorm16(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+    return (short)lrintf(value * 32767.0f);
+}
+
+static unsigned char toUnorm8(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < 0.0f) value = 0.0f;
+    return (unsigned char)lrintf(value * 255.0f);
+}
+
+static void encodeComponent(GLenum type, float value, unsigned char* dst) {
+    switch (type) {
+    case GL_SHORT: {
+        short packed = toSnorm16(value);
+        memcpy(dst, &packed, sizeof(packed));
+        break;
+    }
+    case GL_UNSIGNED_BYTE:
+        *dst = toUnorm8(value);
+        break;
+    default:
+        memcpy(dst, &value, sizeof(value));
+        break;
+    }
+}
+
+static size_t componentSize(GLenum type) {
+    switch (type) {
+    case GL_SHORT: return sizeof(short);
+    case GL_UNSIGNED_BYTE: return 1;
+    default: return sizeof(float);
+    }
+}
+
+void encodeVertices(const VertexFormat& format, const float* vertices, size_t vertexCount, unsigned char* out) {
+    if (&format == &floatVertexFormat) {
+        // already the build layout
+        if (vertexCount > 0) memcpy(out, vertices, vertexCount * format.stride);
+        return;
+    }
+
+    unsigned char* dst = out;
+    for (size_t i = 0; i < vertexCount; i++, vertices += 5, dst += format.stride) {
+        for (int a = 0; a < format.attribCount; a++) {
+            const VertexAttrib& attrib = format.attribs[a];
+            size_t size = componentSize(attrib.type);
+            for (int c = 0; c < attrib.size; c++) {
+                float value = (c < attrib.sourceSize) ? vertices[attrib.source + c] : 1.0f;
+                encodeComponent(attrib.type, value, dst + attrib.offset + c * size);
+            }
+        }
+    }
+}
+
+void applyVertexFormat(const VertexFormat& format) {
+    for (int i = 0; i < format.attribCount; i++) {
+        const VertexAttrib& attrib = format.attribs[i];
+        glVertexAttribPointer(attrib.location, attrib.size, attrib.type, attrib.normalized, format.stride, (void*)attrib.offset);
+        cachedEnableVertexAttribArray(attrib.location);
+    }
+}
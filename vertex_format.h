@@ -0,0 +1,41 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+#include "gl_loader.h"
+#include <cstddef>
+
+// GPU layout of the [x, y, r, g, b] vertices built by shapes.cpp
+// the shaders read vPosition (location 0) and vColor (location 1) as floats either way;
+// normalized integer attributes are converted by the vertex fetch
+#define VERTEX_FORMAT_MAX_ATTRIBS 4
+
+struct VertexAttrib {
+    GLuint location;
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+    int source, sourceSize; // floats taken from the [x, y, r, g, b] vertex, missing components are 1
+};
+
+struct VertexFormat {
+    const char* name;
+    GLsizei stride;
+    int attribCount;
+    VertexAttrib attribs[VERTEX_FORMAT_MAX_ATTRIBS];
+};
+
+// 2 x float position, 3 x float colour, 20 bytes
+extern const VertexFormat floatVertexFormat;
+// 2 x normalized GL_SHORT position in NDC (clamped to [-1, 1]), RGBA8 colour, 8 bytes
+extern const VertexFormat packedVertexFormat;
+
+// NULL if no format has that name
+const VertexFormat* findVertexFormat(const char* name);
+
+// converts interleaved float vertices into the format's byte layout; out holds vertexCount * stride bytes
+void encodeVertices(const VertexFormat& format, const float* vertices, size_t vertexCount, unsigned char* out);
+
+// attribute pointers for the VAO and GL_ARRAY_BUFFER currently bound
+void applyVertexFormat(const VertexFormat& format);
+
+#endif